@@ -4,12 +4,13 @@
 
 #include "DataTables.hpp"
 
-#include <SFML/Graphics/RenderTarget.hpp>
 
 #include "Projectile.hpp"
+#include "RenderSnapshot.hpp"
 #include "ResourceHolder.hpp"
 #include "Utility.hpp"
 #include "DataTables.hpp"
+#include "EntityFactory.hpp"
 #include "Pickup.hpp"
 #include "PickupType.hpp"
 #include "SoundNode.hpp"
@@ -23,11 +24,12 @@ namespace
 }
 
 
-Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontHolder& fonts)
+Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontHolder* fonts, EntityFactory& factory)
 : Entity(Table[static_cast<int>(type)].m_hitpoints)
 , m_type(type)
+, m_factory(factory)
 , m_sprite(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_walk_texture_rect)
-, m_splatter(textures.Get(Textures::kSplatter))
+, m_splatter(textures.Get(Textures::kSplatter), Table[static_cast<int>(type)].m_splatter_animation)
 , m_is_firing(false)
 , m_is_launching_missile(false)
 , m_fire_countdown(sf::Time::Zero)
@@ -47,12 +49,14 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 , m_identifier(0)
 , m_TeamPink(true)
 , is_dead(false)
+, m_has_walk_animation(Table[static_cast<int>(type)].m_has_roll_animation)
+, m_walk_animation(0)
 {
-	m_splatter.SetFrameSize(sf::Vector2i(100, 100));
-	m_splatter.SetNumFrames(14);
-	m_splatter.SetDuration(sf::seconds(1));
+	if (m_has_walk_animation)
+	{
+		m_walk_animation = m_factory.GetAnimator().Add(m_sprite, Table[static_cast<int>(type)].m_walk_animation);
+	}
 	
-	m_current_walk_frame = 0;
 	m_current_shoot_frame = 0;
 
 
@@ -60,15 +64,15 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 	Utility::CentreOrigin(m_splatter);
 
 	m_fire_command.category = static_cast<int>(Category::Type::kScene);
-	m_fire_command.action = [this, &textures](SceneNode& node, sf::Time)
+	m_fire_command.action = [this](SceneNode& node, sf::Time)
 	{
-		CreateBullets(node, textures);
+		CreateBullets(node);
 	};
 
 	m_missile_command.category = static_cast<int>(Category::Type::kScene);
-	m_missile_command.action = [this, &textures](SceneNode& node, sf::Time)
+	m_missile_command.action = [this](SceneNode& node, sf::Time)
 	{
-		CreateProjectile(node, ProjectileType::kMissile, 0.f, 0.5f, textures);
+		CreateProjectile(node, ProjectileType::kMissile, 0.f, 0.5f);
 	};
 
 	m_drop_pickup_command.category = static_cast<int>(Category::Type::kScene);
@@ -77,16 +81,20 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 		CreatePickup(node, textures);
 	};
 	
-	std::unique_ptr<TextNode> healthDisplay(new TextNode(fonts, ""));
-	m_health_display = healthDisplay.get();
-	AttachChild(std::move(healthDisplay));
-
-	if (Aircraft::GetCategory() == static_cast<int>(Category::kPlayerAircraft))
+	//Without fonts (a headless world) the aircraft goes without its text displays
+	if (fonts)
 	{
-		std::unique_ptr<TextNode> missileDisplay(new TextNode(fonts, ""));
-		missileDisplay->setPosition(0, 70);
-		m_ball_display = missileDisplay.get();
-		AttachChild(std::move(missileDisplay));
+		std::unique_ptr<TextNode> healthDisplay(new TextNode(*fonts, ""));
+		m_health_display = healthDisplay.get();
+		AttachChild(std::move(healthDisplay));
+
+		if (Aircraft::GetCategory() == static_cast<int>(Category::kPlayerAircraft))
+		{
+			std::unique_ptr<TextNode> missileDisplay(new TextNode(*fonts, ""));
+			missileDisplay->setPosition(0, 70);
+			m_ball_display = missileDisplay.get();
+			AttachChild(std::move(missileDisplay));
+		}
 	}
 
 	//UpdateTexts();
@@ -95,6 +103,14 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 
 }
 
+Aircraft::~Aircraft()
+{
+	if (m_has_walk_animation)
+	{
+		m_factory.GetAnimator().Remove(m_walk_animation);
+	}
+}
+
 int Aircraft::GetMissileAmmo() const
 {
 	return m_missile_ammo;
@@ -105,18 +121,27 @@ void Aircraft::SetMissileAmmo(int ammo)
 	m_missile_ammo = ammo;
 }
 
-void Aircraft::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void Aircraft::DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const
 {
 	if(IsDestroyed() && m_show_Splatter)
 	{
-		target.draw(m_splatter, states);
+		m_splatter.Draw(snapshot, states);
 	}
 	else
 	{
-		target.draw(m_sprite, states);
+		snapshot.Draw(m_sprite, states);
 	}
 }
 
+sf::FloatRect Aircraft::GetDrawBounds() const
+{
+	if(IsDestroyed() && m_show_Splatter)
+	{
+		return m_splatter.GetGlobalBounds();
+	}
+	return m_sprite.getGlobalBounds();
+}
+
 void Aircraft::DisablePickups()
 {
 	m_pickups_enabled = false;
@@ -162,6 +187,10 @@ void Aircraft::CollectMissiles(unsigned int count)
 
 void Aircraft::UpdateTexts()
 {
+	if (!m_health_display)
+	{
+		return;
+	}
 	if(IsDestroyed())
 	{
 		m_health_display->SetString("");
@@ -211,7 +240,7 @@ void Aircraft::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 		// Play Splatter sound only once
 		if (!m_splatter_began)
 		{
-			SoundEffect soundEffect = (Utility::RandomInt(2) == 0) ? SoundEffect::kSplatter1 : SoundEffect::kSplatter2;
+			SoundEffect soundEffect = (m_factory.GetRandom().NextInt(2) == 0) ? SoundEffect::kSplatter1 : SoundEffect::kSplatter2;
 			PlayLocalSound(commands, soundEffect);
 
 			//Emit network game action for enemy explodes
@@ -340,23 +369,23 @@ bool Aircraft::IsAlliedPink() const
 
 
 //TODO Do enemies need a different offset as they are flying down the screen?
-void Aircraft::CreateBullets(SceneNode& node, const TextureHolder& textures) const
+void Aircraft::CreateBullets(SceneNode& node) const
 {
 	ProjectileType type = IsAlliedPink() ? ProjectileType::kAlliedBullet : ProjectileType::kEnemyBullet;
 	if (m_has_ball == true) {
 		switch (m_spread_level)
 		{
 		case 1:
-			CreateProjectile(node, type, 0.0f, 0.5f, textures);
+			CreateProjectile(node, type, 0.0f, 0.5f);
 			break;
 		case 2:
-			CreateProjectile(node, type, -0.5f, 0.5f, textures);
-			CreateProjectile(node, type, 0.5f, 0.5f, textures);
+			CreateProjectile(node, type, -0.5f, 0.5f);
+			CreateProjectile(node, type, 0.5f, 0.5f);
 			break;
 		case 3:
-			CreateProjectile(node, type, -0.5f, 0.5f, textures);
-			CreateProjectile(node, type, 0.0f, 0.5f, textures);
-			CreateProjectile(node, type, 0.5f, 0.5f, textures);
+			CreateProjectile(node, type, -0.5f, 0.5f);
+			CreateProjectile(node, type, 0.0f, 0.5f);
+			CreateProjectile(node, type, 0.5f, 0.5f);
 			break;
 
 		}
@@ -365,10 +394,9 @@ void Aircraft::CreateBullets(SceneNode& node, const TextureHolder& textures) con
 	//m_has_ball == false;
 }
 
-void Aircraft::CreateProjectile(SceneNode& node, ProjectileType type, float x_offset, float y_offset,
-	const TextureHolder& textures) const
+void Aircraft::CreateProjectile(SceneNode& node, ProjectileType type, float x_offset, float y_offset) const
 {
-	std::unique_ptr<Projectile> projectile(new Projectile(type, textures));
+	std::unique_ptr<Projectile> projectile = m_factory.CreateProjectile(type);
 	sf::Vector2f offset(x_offset * m_sprite.getGlobalBounds().width, y_offset * m_sprite.getGlobalBounds().height);
 	//for left side team
 
@@ -421,39 +449,14 @@ void Aircraft::CreatePickup(SceneNode& node, const TextureHolder& textures) cons
 }
 
 
+//The walk cycle plays while the aircraft moves, the World's Animator advances it along with every other animation
 void Aircraft::UpdateRollAnimation()
 {
-	//std::cout << m_current_walk_frame << std::endl;
-	if (Table[static_cast<int>(m_type)].m_has_roll_animation)
+	if (m_has_walk_animation)
 	{
-		sf::IntRect textureRect = Table[static_cast<int>(m_type)].m_walk_texture_rect;
-		if (m_is_firing == false && GetVelocity().x < 0.0f || GetVelocity().x > 0.0f || GetVelocity().y < 0.0f || GetVelocity().y > 0.0f) 
-		{ 
-			textureRect = Table[static_cast<int>(m_type)].m_walk_texture_rect;
-			if (m_current_walk_frame == 0 && clock.getElapsedTime().asMilliseconds() > 100.0f)
-			{
-				time_since_last_frame = clock.getElapsedTime().asSeconds();
-				m_current_walk_frame++;
-				m_sprite.setTextureRect(textureRect);
-			}
-			else if (clock.getElapsedTime().asMilliseconds() > time_since_last_frame + 250.0f)
-			{
-				time_since_last_frame += 250.0f;
-				
-				textureRect.left += m_current_walk_frame * textureRect.width;
-				//std::cout << textureRect.left << std::endl;
-				m_current_walk_frame++;
-				//std::cout << m_current_walk_frame << std::endl;
-				//m_sprite.setTextureRect(textureRect);
-				if (m_current_walk_frame > Table[static_cast<int>(m_type)].m_walk_animation_frames - 1)
-				{
-					m_current_walk_frame = 0; 
-					clock.restart();
-				}
-				m_sprite.setTextureRect(textureRect);
-			}
-		}
-		//m_sprite.setTextureRect(textureRect);
+		const sf::Vector2f velocity = GetVelocity();
+		const bool moving = (!m_is_firing && velocity.x < 0.f) || velocity.x > 0.f || velocity.y < 0.f || velocity.y > 0.f;
+		m_factory.GetAnimator().SetPlaying(m_walk_animation, moving);
 	}
 }
 
@@ -473,6 +476,49 @@ void Aircraft::PlayLocalSound(CommandQueue& commands, SoundEffect effect)
 	commands.Push(command);
 }
 
+//Gameplay state only, the walk cycle and splatter animation are cosmetic and carry on from where they are
+void Aircraft::SaveState(WorldState& state) const
+{
+	Entity::SaveState(state);
+	state.Write(m_fire_countdown.asMicroseconds());
+	state.Write(m_fire_rate);
+	state.Write(m_spread_level);
+	state.Write(m_missile_ammo);
+	state.Write(m_travelled_distance);
+	state.Write(m_directions_index);
+	state.Write(m_is_firing);
+	state.Write(m_is_launching_missile);
+	state.Write(m_has_ball);
+	state.Write(m_splatter_began);
+	state.Write(m_show_Splatter);
+	state.Write(m_splatter.GetElapsedTime().asMicroseconds());
+	if (m_has_walk_animation)
+	{
+		state.Write(m_factory.GetAnimator().GetElapsedTime(m_walk_animation).asMicroseconds());
+	}
+}
+
+void Aircraft::RestoreState(WorldState::Reader& state)
+{
+	Entity::RestoreState(state);
+	m_fire_countdown = sf::microseconds(state.Read<sf::Int64>());
+	m_fire_rate = state.Read<unsigned int>();
+	m_spread_level = state.Read<unsigned int>();
+	m_missile_ammo = state.Read<unsigned int>();
+	m_travelled_distance = state.Read<float>();
+	m_directions_index = state.Read<int>();
+	m_is_firing = state.Read<bool>();
+	m_is_launching_missile = state.Read<bool>();
+	m_has_ball = state.Read<bool>();
+	m_splatter_began = state.Read<bool>();
+	m_show_Splatter = state.Read<bool>();
+	m_splatter.SetElapsedTime(sf::microseconds(state.Read<sf::Int64>()));
+	if (m_has_walk_animation)
+	{
+		m_factory.GetAnimator().SetElapsedTime(m_walk_animation, sf::microseconds(state.Read<sf::Int64>()));
+	}
+}
+
 void Aircraft::PickUpBall()
 {
 	m_has_ball = true;
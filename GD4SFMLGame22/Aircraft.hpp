@@ -6,6 +6,7 @@
 #include <SFML/Graphics/Sprite.hpp>
 
 #include "Animation.hpp"
+#include "Animator.hpp"
 #include "CommandQueue.hpp"
 #include "ProjectileType.hpp"
 #include "TextNode.hpp"
@@ -15,10 +16,13 @@
 
 #include "Layers.hpp"
 
+class EntityFactory;
+
 class Aircraft : public Entity
 {
 public:
-	Aircraft(AircraftType type, const TextureHolder& textures, const FontHolder& fonts);
+	Aircraft(AircraftType type, const TextureHolder& textures, const FontHolder* fonts, EntityFactory& factory);
+	~Aircraft();
 	unsigned int GetCategory() const override;
 
 	void DisablePickups();
@@ -35,8 +39,8 @@ public:
 	float GetMaxSpeed() const;
 	void Fire();
 	void LaunchMissile();
-	void CreateBullets(SceneNode& node, const TextureHolder& textures) const;
-	void CreateProjectile(SceneNode& node, ProjectileType type, float x_offset, float y_offset, const TextureHolder& textures) const;
+	void CreateBullets(SceneNode& node) const;
+	void CreateProjectile(SceneNode& node, ProjectileType type, float x_offset, float y_offset) const;
 
 	sf::FloatRect GetBoundingRect() const override;
 	bool IsMarkedForRemoval() const override;
@@ -49,10 +53,14 @@ public:
 	bool GetTeamPink();
 	void SetTeamPink(bool team);
 
+	void SaveState(WorldState& state) const override;
+	void RestoreState(WorldState::Reader& state) override;
+
 	
 	
 private:
-	void DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const override;
+	void DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const override;
+	sf::FloatRect GetDrawBounds() const override;
 	void UpdateCurrent(sf::Time dt, CommandQueue& commands) override;
 	
 	void CheckProjectileLaunch(sf::Time dt, CommandQueue& commands);
@@ -62,10 +70,8 @@ private:
 	void UpdateRollAnimation();
 
 private:
-	sf::Clock clock;
-	float time_since_last_frame;
-
 	AircraftType m_type;
+	EntityFactory& m_factory;
 	sf::Sprite m_sprite;
 	Animation m_splatter;
 
@@ -98,10 +104,12 @@ private:
 
 	int m_identifier;
 
-	int m_current_walk_frame = 0;
 	int m_current_shoot_frame = 0;
 	bool m_TeamPink ;
 
 	bool is_dead;
 
+	bool m_has_walk_animation;
+	Animator::Index m_walk_animation;
+
 };
@@ -0,0 +1,74 @@
+#include "AircraftRegistry.hpp"
+
+namespace
+{
+	//Identifiers arrive in network packets, anything above this is not an aircraft the server could have handed out
+	//in a match, it is well beyond its player cap, and growing the array for it would only waste memory
+	const int kMaxIdentifier = 4096;
+}
+
+AircraftRegistry::Entry::Entry()
+	: m_handle()
+	, m_local(false)
+{
+}
+
+AircraftRegistry::AircraftRegistry()
+	: m_entries()
+{
+}
+
+//Identifiers out of range are ignored, Get then finds no aircraft for them
+void AircraftRegistry::Add(int identifier, EntityHandle handle)
+{
+	Entry* entry = GetEntry(identifier);
+	if (entry)
+	{
+		entry->m_handle = handle;
+	}
+}
+
+//Keeps the local flag, a local player may get a new aircraft under the same identifier
+void AircraftRegistry::Remove(int identifier)
+{
+	if (identifier >= 0 && static_cast<std::size_t>(identifier) < m_entries.size())
+	{
+		m_entries[identifier].m_handle = EntityHandle();
+	}
+}
+
+EntityHandle AircraftRegistry::Get(int identifier) const
+{
+	if (identifier < 0 || static_cast<std::size_t>(identifier) >= m_entries.size())
+	{
+		return EntityHandle();
+	}
+	return m_entries[identifier].m_handle;
+}
+
+void AircraftRegistry::SetLocal(int identifier, bool local)
+{
+	Entry* entry = GetEntry(identifier);
+	if (entry)
+	{
+		entry->m_local = local;
+	}
+}
+
+bool AircraftRegistry::IsLocal(int identifier) const
+{
+	return identifier >= 0 && static_cast<std::size_t>(identifier) < m_entries.size() && m_entries[identifier].m_local;
+}
+
+AircraftRegistry::Entry* AircraftRegistry::GetEntry(int identifier)
+{
+	if (identifier < 0 || identifier > kMaxIdentifier)
+	{
+		return nullptr;
+	}
+	if (static_cast<std::size_t>(identifier) >= m_entries.size())
+	{
+		m_entries.resize(identifier + 1);
+	}
+	return &m_entries[identifier];
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "EntityHandle.hpp"
+
+//Player aircraft indexed by their network identifier
+//The server hands identifiers out counting up from 1, so a dense array gives constant time lookups without hashing
+//Each entry also records whether the aircraft is controlled on this machine or is a remote player
+class AircraftRegistry
+{
+public:
+	AircraftRegistry();
+
+	void Add(int identifier, EntityHandle handle);
+	void Remove(int identifier);
+	EntityHandle Get(int identifier) const;
+
+	void SetLocal(int identifier, bool local);
+	bool IsLocal(int identifier) const;
+
+private:
+	struct Entry
+	{
+		Entry();
+
+		EntityHandle m_handle;
+		bool m_local;
+	};
+
+private:
+	//Grows the array up to the identifier, nullptr for identifiers no server hands out
+	Entry* GetEntry(int identifier);
+
+private:
+	std::vector<Entry> m_entries;
+};
@@ -0,0 +1,71 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<std::size_t> AllocationCount(0);
+
+	void* CountedAllocate(std::size_t size)
+	{
+		AllocationCount.fetch_add(1, std::memory_order_relaxed);
+		if (size == 0)
+		{
+			size = 1;
+		}
+
+		while (true)
+		{
+			void* memory = std::malloc(size);
+			if (memory)
+			{
+				return memory;
+			}
+
+			std::new_handler handler = std::get_new_handler();
+			if (!handler)
+			{
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+	}
+}
+
+std::size_t AllocationCounter::GetAllocationCount()
+{
+	return AllocationCount.load(std::memory_order_relaxed);
+}
+
+//Replacements for the global allocation functions, every new/delete in the program goes through these
+void* operator new(std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
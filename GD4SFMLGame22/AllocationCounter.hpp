@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+
+//Counts every allocation made through the global operator new
+//Take the difference of two readings to see how many heap allocations a piece of code made
+class AllocationCounter
+{
+public:
+	static std::size_t GetAllocationCount();
+};
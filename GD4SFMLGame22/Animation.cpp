@@ -1,27 +1,24 @@
 #include "Animation.hpp"
 
-#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
+#include "RenderSnapshot.hpp"
+
 
 Animation::Animation()
-	: m_num_frames(0)
+	: m_clip(nullptr)
 	, m_current_frame(0)
-	, m_duration(sf::Time::Zero)
 	, m_elapsed_time(sf::Time::Zero)
-	, m_repeat(false)
 {
 }
 
-Animation::Animation(const sf::Texture& texture)
+Animation::Animation(const sf::Texture& texture, const AnimationClip& clip)
 	: m_sprite(texture)
-	, m_frame_size()
-	, m_num_frames(0)
+	, m_clip(nullptr)
 	, m_current_frame(0)
-	, m_duration(sf::Time::Zero)
 	, m_elapsed_time(sf::Time::Zero)
-	, m_repeat(false)
 {
+	SetClip(clip);
 }
 
 void Animation::SetTexture(const sf::Texture& texture)
@@ -34,54 +31,45 @@ const sf::Texture* Animation::GetTexture() const
 	return m_sprite.getTexture();
 }
 
-void Animation::SetFrameSize(sf::Vector2i frameSize)
-{
-	m_frame_size = frameSize;
-}
-
-sf::Vector2i Animation::GetFrameSize() const
-{
-	return m_frame_size;
-}
-
-void Animation::SetNumFrames(std::size_t numFrames)
-{
-	m_num_frames = numFrames;
-}
-
-std::size_t Animation::GetNumFrames() const
+void Animation::SetClip(const AnimationClip& clip)
 {
-	return m_num_frames;
+	m_clip = &clip;
+	Restart();
 }
 
-void Animation::SetDuration(sf::Time duration)
+const AnimationClip* Animation::GetClip() const
 {
-	m_duration = duration;
+	return m_clip;
 }
 
-sf::Time Animation::GetDuration() const
+sf::Vector2i Animation::GetFrameSize() const
 {
-	return m_duration;
+	return m_clip ? m_clip->GetFrameSize() : sf::Vector2i();
 }
 
-void Animation::SetRepeating(bool flag)
+sf::Time Animation::GetElapsedTime() const
 {
-	m_repeat = flag;
+	return m_elapsed_time;
 }
 
-bool Animation::IsRepeating() const
+void Animation::SetElapsedTime(sf::Time elapsed)
 {
-	return m_repeat;
+	m_elapsed_time = elapsed;
+	if (m_clip)
+	{
+		m_current_frame = m_clip->GetFrameAt(m_elapsed_time);
+		m_sprite.setTextureRect(m_clip->GetFrame(m_current_frame));
+	}
 }
 
 void Animation::Restart()
 {
-	m_current_frame = 0;
+	SetElapsedTime(sf::Time::Zero);
 }
 
 bool Animation::IsFinished() const
 {
-	return m_current_frame >= m_num_frames;
+	return !m_clip || m_clip->IsFinished(m_elapsed_time);
 }
 
 sf::FloatRect Animation::GetLocalBounds() const
@@ -96,49 +84,23 @@ sf::FloatRect Animation::GetGlobalBounds() const
 
 void Animation::Update(sf::Time dt)
 {
-	sf::Time timePerFrame = m_duration / static_cast<float>(m_num_frames);
-	m_elapsed_time += dt;
-
-	sf::Vector2i textureBounds(m_sprite.getTexture()->getSize());
-	sf::IntRect textureRect = m_sprite.getTextureRect();
-
-	if (m_current_frame == 0)
-		textureRect = sf::IntRect(0, 0, m_frame_size.x, m_frame_size.y);
-
-	// While we have a frame to process
-	while (m_elapsed_time >= timePerFrame && (m_current_frame <= m_num_frames || m_repeat))
+	if (!m_clip)
 	{
-		// Move the texture rect left
-		textureRect.left += textureRect.width;
-
-		// If we reach the end of the texture
-		if (textureRect.left + textureRect.width > textureBounds.x)
-		{
-			// Move it down one line
-			textureRect.left = 0;
-			textureRect.top += textureRect.height;
-		}
-
-		// And progress to next frame
-		m_elapsed_time -= timePerFrame;
-		if (m_repeat)
-		{
-			m_current_frame = (m_current_frame + 1) % m_num_frames;
-
-			if (m_current_frame == 0)
-				textureRect = sf::IntRect(0, 0, m_frame_size.x, m_frame_size.y);
-		}
-		else
-		{
-			m_current_frame++;
-		}
+		return;
 	}
 
-	m_sprite.setTextureRect(textureRect);
+	//The clip already knows every frame rect, only a change of frame touches the sprite
+	m_elapsed_time += dt;
+	const std::size_t frame = m_clip->GetFrameAt(m_elapsed_time);
+	if (frame != m_current_frame)
+	{
+		m_current_frame = frame;
+		m_sprite.setTextureRect(m_clip->GetFrame(frame));
+	}
 }
 
-void Animation::draw(sf::RenderTarget& target, sf::RenderStates states) const
+void Animation::Draw(RenderSnapshot& snapshot, sf::RenderStates states) const
 {
 	states.transform *= getTransform();
-	target.draw(m_sprite, states);
+	snapshot.Draw(m_sprite, states);
 }
\ No newline at end of file
@@ -1,28 +1,28 @@
 #pragma once
+#include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Time.hpp>
 
+#include "AnimationClip.hpp"
 
-class Animation : public sf::Drawable, public sf::Transformable
+class RenderSnapshot;
+
+//A sprite playing one precomputed AnimationClip, the clip must outlive the animation
+class Animation : public sf::Transformable
 {
 public:
 	Animation();
-	explicit Animation(const sf::Texture& texture);
+	Animation(const sf::Texture& texture, const AnimationClip& clip);
 
 	void SetTexture(const sf::Texture& texture);
 	const sf::Texture* GetTexture() const;
 
-	void SetFrameSize(sf::Vector2i mFrameSize);
+	void SetClip(const AnimationClip& clip);
+	const AnimationClip* GetClip() const;
 	sf::Vector2i GetFrameSize() const;
 
-	void SetNumFrames(std::size_t numFrames);
-	std::size_t GetNumFrames() const;
-
-	void SetDuration(sf::Time duration);
-	sf::Time GetDuration() const;
-
-	void SetRepeating(bool flag);
-	bool IsRepeating() const;
+	sf::Time GetElapsedTime() const;
+	void SetElapsedTime(sf::Time elapsed);
 
 	void Restart();
 	bool IsFinished() const;
@@ -31,19 +31,13 @@ public:
 	sf::FloatRect GetGlobalBounds() const;
 
 	void Update(sf::Time dt);
-
-
-private:
-	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+	void Draw(RenderSnapshot& snapshot, sf::RenderStates states) const;
 
 
 private:
 	sf::Sprite m_sprite;
-	sf::Vector2i m_frame_size;
-	std::size_t m_num_frames;
+	const AnimationClip* m_clip;
 	std::size_t m_current_frame;
-	sf::Time m_duration;
 	sf::Time m_elapsed_time;
-	bool m_repeat;
 };
 
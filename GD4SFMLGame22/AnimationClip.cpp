@@ -0,0 +1,80 @@
+#include "AnimationClip.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+AnimationClip::AnimationClip()
+	: m_frames()
+	, m_frame_time(sf::Time::Zero)
+	, m_repeat(false)
+{
+}
+
+AnimationClip::AnimationClip(const sf::IntRect& first_frame, std::size_t frame_count, int sheet_width, sf::Time frame_time, bool repeat)
+	: m_frames()
+	, m_frame_time(frame_time)
+	, m_repeat(repeat)
+{
+	assert(frame_count > 0);
+	m_frames.reserve(frame_count);
+	sf::IntRect frame = first_frame;
+	for (std::size_t i = 0; i < frame_count; ++i)
+	{
+		if (frame.left + frame.width > sheet_width)
+		{
+			frame.left = 0;
+			frame.top += frame.height;
+		}
+		m_frames.emplace_back(frame);
+		frame.left += frame.width;
+	}
+}
+
+std::size_t AnimationClip::GetFrameCount() const
+{
+	return m_frames.size();
+}
+
+const sf::IntRect& AnimationClip::GetFrame(std::size_t index) const
+{
+	assert(index < m_frames.size());
+	return m_frames[index];
+}
+
+sf::Vector2i AnimationClip::GetFrameSize() const
+{
+	return m_frames.empty() ? sf::Vector2i() : sf::Vector2i(m_frames.front().width, m_frames.front().height);
+}
+
+sf::Time AnimationClip::GetFrameTime() const
+{
+	return m_frame_time;
+}
+
+sf::Time AnimationClip::GetDuration() const
+{
+	return m_frame_time * static_cast<sf::Int64>(m_frames.size());
+}
+
+bool AnimationClip::IsRepeating() const
+{
+	return m_repeat;
+}
+
+std::size_t AnimationClip::GetFrameAt(sf::Time elapsed) const
+{
+	assert(!m_frames.empty());
+	//Whole microseconds, so every peer lands on the same frame after the same ticks
+	const sf::Int64 frame_time = std::max<sf::Int64>(m_frame_time.asMicroseconds(), 1);
+	const std::size_t frame = static_cast<std::size_t>(std::max<sf::Int64>(elapsed.asMicroseconds(), 0) / frame_time);
+	if (m_repeat)
+	{
+		return frame % m_frames.size();
+	}
+	return std::min(frame, m_frames.size() - 1);
+}
+
+bool AnimationClip::IsFinished(sf::Time elapsed) const
+{
+	return !m_repeat && elapsed >= GetDuration();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <cstddef>
+#include <vector>
+
+//The frame rects of one animation, laid out once when the data tables are loaded
+//Frames run left to right from the first one and carry on at the start of the next row when they reach the edge of the sheet
+//Which frame shows follows from how long the clip has played, so playing it is a division and a lookup
+class AnimationClip
+{
+public:
+	AnimationClip();
+	AnimationClip(const sf::IntRect& first_frame, std::size_t frame_count, int sheet_width, sf::Time frame_time, bool repeat);
+
+	std::size_t GetFrameCount() const;
+	const sf::IntRect& GetFrame(std::size_t index) const;
+	sf::Vector2i GetFrameSize() const;
+	sf::Time GetFrameTime() const;
+	sf::Time GetDuration() const;
+	bool IsRepeating() const;
+
+	//Repeating clips wrap around, the others stay on their last frame once they have played through
+	std::size_t GetFrameAt(sf::Time elapsed) const;
+	bool IsFinished(sf::Time elapsed) const;
+
+private:
+	std::vector<sf::IntRect> m_frames;
+	sf::Time m_frame_time;
+	bool m_repeat;
+};
@@ -0,0 +1,108 @@
+#include "Animator.hpp"
+
+#include <SFML/Graphics/Sprite.hpp>
+
+#include <cassert>
+
+Animator::Animator()
+	: m_sprites()
+	, m_clips()
+	, m_elapsed()
+	, m_frames()
+	, m_flags()
+	, m_free_slots()
+{
+}
+
+Animator::Index Animator::Add(sf::Sprite& sprite, const AnimationClip& clip)
+{
+	Index index;
+	if (m_free_slots.empty())
+	{
+		index = m_sprites.size();
+		m_sprites.emplace_back(nullptr);
+		m_clips.emplace_back(nullptr);
+		m_elapsed.emplace_back(sf::Time::Zero);
+		m_frames.emplace_back(0);
+		m_flags.emplace_back(kNone);
+	}
+	else
+	{
+		index = m_free_slots.back();
+		m_free_slots.pop_back();
+	}
+
+	m_sprites[index] = &sprite;
+	m_clips[index] = &clip;
+	m_elapsed[index] = sf::Time::Zero;
+	m_flags[index] = kInUse;
+	ShowFrame(index, 0);
+	return index;
+}
+
+void Animator::Remove(Index index)
+{
+	assert(m_flags[index] & kInUse);
+	m_sprites[index] = nullptr;
+	m_clips[index] = nullptr;
+	m_flags[index] = kNone;
+	m_free_slots.emplace_back(index);
+}
+
+std::size_t Animator::GetSize() const
+{
+	return m_sprites.size() - m_free_slots.size();
+}
+
+void Animator::SetPlaying(Index index, bool playing)
+{
+	assert(m_flags[index] & kInUse);
+	if (playing)
+	{
+		m_flags[index] |= kPlaying;
+	}
+	else
+	{
+		m_flags[index] &= ~kPlaying;
+	}
+}
+
+bool Animator::IsPlaying(Index index) const
+{
+	return (m_flags[index] & kPlaying) != 0;
+}
+
+sf::Time Animator::GetElapsedTime(Index index) const
+{
+	return m_elapsed[index];
+}
+
+void Animator::SetElapsedTime(Index index, sf::Time elapsed)
+{
+	assert(m_flags[index] & kInUse);
+	m_elapsed[index] = elapsed;
+	ShowFrame(index, m_clips[index]->GetFrameAt(elapsed));
+}
+
+void Animator::Update(sf::Time dt)
+{
+	for (Index i = 0; i < m_flags.size(); ++i)
+	{
+		//Only slots in use are ever playing
+		if (m_flags[i] & kPlaying)
+		{
+			m_elapsed[i] += dt;
+			const std::size_t frame = m_clips[i]->GetFrameAt(m_elapsed[i]);
+			if (frame != m_frames[i])
+			{
+				ShowFrame(i, frame);
+			}
+		}
+	}
+}
+
+void Animator::ShowFrame(Index index, std::size_t frame)
+{
+	m_frames[index] = frame;
+	m_sprites[index]->setTextureRect(m_clips[index]->GetFrame(frame));
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include "AnimationClip.hpp"
+
+namespace sf
+{
+	class Sprite;
+}
+
+//Plays the animation clips of every animated sprite in a World in one pass per tick
+//Clips advance by the simulation step rather than a clock, so the same ticks show the same frames on every peer and after a rollback
+//A sprite's texture rect is only touched on the ticks its frame changes
+//Slots keep their index while in use, removed ones are handed out again by the next Add
+class Animator : private sf::NonCopyable
+{
+public:
+	typedef std::size_t Index;
+
+public:
+	Animator();
+
+	//The sprite shows the clip's first frame straight away, the clip must outlive the slot
+	Index Add(sf::Sprite& sprite, const AnimationClip& clip);
+	void Remove(Index index);
+	std::size_t GetSize() const;
+
+	void SetPlaying(Index index, bool playing);
+	bool IsPlaying(Index index) const;
+	sf::Time GetElapsedTime(Index index) const;
+	void SetElapsedTime(Index index, sf::Time elapsed);
+
+	void Update(sf::Time dt);
+
+private:
+	enum Flags
+	{
+		kNone = 0,
+		kInUse = 1 << 0,
+		kPlaying = 1 << 1
+	};
+
+private:
+	void ShowFrame(Index index, std::size_t frame);
+
+private:
+	std::vector<sf::Sprite*> m_sprites;
+	std::vector<const AnimationClip*> m_clips;
+	std::vector<sf::Time> m_elapsed;
+	std::vector<std::size_t> m_frames;
+	std::vector<unsigned int> m_flags;
+	std::vector<Index> m_free_slots;
+};
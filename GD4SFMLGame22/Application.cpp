@@ -1,5 +1,14 @@
 #include "Application.hpp"
 
+#include <SFML/System/Sleep.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include "AllocationCounter.hpp"
+#include "RenderSnapshot.hpp"
+
 #include "GameOverState.hpp"
 #include "State.hpp"
 #include "StateID.hpp"
@@ -11,18 +20,43 @@
 #include "MultiplayerGameState.hpp"
 
 
-const sf::Time Application::kTimePerFrame = sf::seconds(1.f / 60.f);
+const unsigned int Application::kDefaultSimulationFrequency = 60;
+const unsigned int Application::kDefaultMaxCatchUpSteps = 5;
+//Beyond this the step gets too short to measure in microseconds, and the frame timing divides by it
+const unsigned int Application::kMaxSimulationFrequency = 1000;
+//Presenting happens on the render thread, so nothing else holds the main loop back
+const unsigned int Application::kDefaultFrameRateLimit = 144;
+
+namespace
+{
+	//Every size the game's text is drawn at, their glyphs are loaded before the render thread starts
+	const unsigned int kCharacterSizes[] = { 10, 16, 20, 30, 35, 70 };
+}
 
 Application::Application()
 :m_window(sf::VideoMode(1920, 1080), "Network", sf::Style::Close)
+, m_render_thread(m_window)
 , m_key_binding_1(1)
 , m_key_binding_2(2)
-, m_stack(State::Context(m_window, m_textures, m_fonts, m_music, m_sounds, m_key_binding_1, m_key_binding_2))
+, m_network_mode(NetworkMode::kRelay)
+, m_stack(State::Context(m_window, m_render_thread, m_textures, m_fonts, m_music, m_sounds, m_key_binding_1, m_key_binding_2, m_network_mode, m_job_system, m_time_per_update))
 , m_statistics_numframes(0)
+, m_statistics_numupdates(0)
+, m_statistics_allocations(0)
+, m_statistics_sprites(0)
+, m_statistics_glyphs(0)
+, m_frame_update_time(sf::Time::Zero)
+, m_time_per_update(sf::seconds(1.f / kDefaultSimulationFrequency))
+, m_max_catch_up_steps(kDefaultMaxCatchUpSteps)
+, m_min_time_per_frame(sf::seconds(1.f / kDefaultFrameRateLimit))
 {
 	m_window.setKeyRepeatEnabled(false);
 
 	m_fonts.Load(Fonts::Main, "Media/Fonts/Sansation.ttf");
+	for (unsigned int size : kCharacterSizes)
+	{
+		RenderSnapshot::PreloadGlyphs(m_fonts.Get(Fonts::Main), size);
+	}
 	m_textures.Load(Textures::kTitleScreen, "Media/Textures/Menu.png");
 	m_textures.Load(Textures::kButtons, "Media/Textures/Buttons.png");
 	m_textures.Load(Textures::KCourt, "Media/Textures/court.png");
@@ -35,28 +69,82 @@ Application::Application()
 	m_stack.PushState(StateID::kMenu);
 }
 
+//The states and resources destroyed after this may be what the last frames point at
+Application::~Application()
+{
+	m_render_thread.Stop();
+}
+
 void Application::Run()
 {
 	sf::Clock clock;
 	sf::Time time_since_last_update = sf::Time::Zero;
+	m_render_thread.Launch();
 	while (m_window.isOpen())
 	{
 		sf::Time elapsedTime = clock.restart();
 		time_since_last_update += elapsedTime;
 
-		while (time_since_last_update > kTimePerFrame)
+		unsigned int steps = 0;
+		while (time_since_last_update >= m_time_per_update && steps < m_max_catch_up_steps)
 		{
-			time_since_last_update -= kTimePerFrame;
+			time_since_last_update -= m_time_per_update;
+			++steps;
 			ProcessInput();
-			Update(kTimePerFrame);
+			Update(m_time_per_update);
 
 			if(m_stack.IsEmpty())
 			{
-				m_window.close();
+				Close();
 			}
 		}
+
+		//After a hitch, drop the backlog rather than spiral trying to catch up with it
+		if (time_since_last_update >= m_time_per_update)
+		{
+			time_since_last_update = sf::microseconds(time_since_last_update.asMicroseconds() % m_time_per_update.asMicroseconds());
+		}
+
 		UpdateStatistics(elapsedTime);
-		Render();
+		Render(time_since_last_update / m_time_per_update);
+
+		//Recording frames faster than they can be shown only burns the CPU
+		sf::Time frame_time = clock.getElapsedTime();
+		if (frame_time < m_min_time_per_frame)
+		{
+			sf::sleep(m_min_time_per_frame - frame_time);
+		}
+	}
+}
+
+void Application::SetSimulationFrequency(unsigned int updates_per_second)
+{
+	updates_per_second = std::max(1u, std::min(updates_per_second, kMaxSimulationFrequency));
+	m_time_per_update = sf::seconds(1.f / updates_per_second);
+}
+
+void Application::SetMaxCatchUpSteps(unsigned int steps)
+{
+	assert(steps > 0);
+	m_max_catch_up_steps = steps;
+}
+
+void Application::SetFrameRateLimit(unsigned int frames_per_second)
+{
+	assert(frames_per_second > 0);
+	m_min_time_per_frame = sf::seconds(1.f / frames_per_second);
+}
+
+void Application::SetNetworkMode(NetworkMode mode)
+{
+	m_network_mode = mode;
+}
+
+void Application::SetStatisticsCsv(const std::string& filename)
+{
+	if (!m_render_statistics.OpenCsv(filename))
+	{
+		throw std::runtime_error("Application::SetStatisticsCsv - Failed to open " + filename);
 	}
 }
 
@@ -68,24 +156,46 @@ void Application::ProcessInput()
 		m_stack.HandleEvent(event);
 		if (event.type == sf::Event::Closed)
 		{
-			m_window.close();
+			Close();
 		}
 	}
 }
 
 void Application::Update(sf::Time delta_time)
 {
+	sf::Clock clock;
+	std::size_t allocations_before = AllocationCounter::GetAllocationCount();
 	m_stack.Update(delta_time);
+	m_statistics_allocations += AllocationCounter::GetAllocationCount() - allocations_before;
+	m_statistics_numupdates += 1;
+	m_frame_update_time += clock.getElapsedTime();
 }
 
-void Application::Render()
+//alpha is how far the current time is between the last update and the next one
+//Only records the frame, the render thread puts it on screen while the next updates run
+void Application::Render(float alpha)
 {
-	m_window.clear();
-	m_stack.Draw();
+	sf::Clock clock;
+	RenderSnapshot& snapshot = m_render_thread.BeginFrame();
+	m_stack.SetInterpolation(alpha);
+	m_stack.Draw(snapshot);
+
+	snapshot.SetView(snapshot.GetDefaultView());
+	snapshot.Draw(m_statistics_text);
+	m_statistics_sprites += snapshot.GetSpriteCount();
+	m_statistics_glyphs += snapshot.GetGlyphCount();
+
+	snapshot.GetSample().m_update += m_frame_update_time;
+	snapshot.GetSample().m_record += clock.getElapsedTime();
+	m_frame_update_time = sf::Time::Zero;
+	m_render_thread.Publish();
+}
 
-	m_window.setView(m_window.getDefaultView());
-	m_window.draw(m_statistics_text);
-	m_window.display();
+//The render thread has to let go of the window's context before the window is destroyed
+void Application::Close()
+{
+	m_render_thread.Stop();
+	m_window.close();
 }
 
 void Application::UpdateStatistics(sf::Time elapsed_time)
@@ -93,14 +203,31 @@ void Application::UpdateStatistics(sf::Time elapsed_time)
 	m_statistics_updatetime += elapsed_time;
 	m_statistics_numframes += 1;
 
+	//The render thread's measurements of the frames it has put on screen since the last call
+	m_render_thread.CollectSamples(m_frame_samples);
+	for (const FrameSample& sample : m_frame_samples)
+	{
+		m_render_statistics.AddFrame(sample);
+	}
+	m_frame_samples.clear();
+
 	if (m_statistics_updatetime >= sf::seconds(1.0f))
 	{
 		m_statistics_text.setString(
 			"Frames / Second = " + std::to_string(m_statistics_numframes) + "\n" +
-			"Time / Update = " + std::to_string(m_statistics_updatetime.asMicroseconds() / m_statistics_numframes) + "us");
+			"Time / Update = " + std::to_string(m_statistics_updatetime.asMicroseconds() / m_statistics_numframes) + "us\n" +
+			"Heap Allocations / Update = " + std::to_string(m_statistics_numupdates > 0 ? m_statistics_allocations / m_statistics_numupdates : 0) + "\n" +
+			"Sprites / Frame = " + std::to_string(m_statistics_sprites / m_statistics_numframes) +
+			", Glyphs / Frame = " + std::to_string(m_statistics_glyphs / m_statistics_numframes) + "\n" +
+			m_render_statistics.GetSummary());
+		m_render_statistics.ResetCounters();
 
 		m_statistics_updatetime -= sf::seconds(1.0f);
 		m_statistics_numframes = 0;
+		m_statistics_numupdates = 0;
+		m_statistics_allocations = 0;
+		m_statistics_sprites = 0;
+		m_statistics_glyphs = 0;
 	}
 }
 
@@ -3,9 +3,13 @@
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/System/Time.hpp>
 
+#include "JobSystem.hpp"
 #include "KeyBinding.hpp"
 #include "MusicPlayer.hpp"
+#include "NetworkMode.hpp"
 #include "Player.hpp"
+#include "RenderStatistics.hpp"
+#include "RenderThread.hpp"
 #include "ResourceHolder.hpp"
 #include "ResourceIdentifiers.hpp"
 #include "StateStack.hpp"
@@ -14,17 +18,27 @@ class Application
 {
 public:
 	Application();
+	~Application();
 	void Run();
+	//Clamped to between 1 and kMaxSimulationFrequency updates per second
+	void SetSimulationFrequency(unsigned int updates_per_second);
+	void SetMaxCatchUpSteps(unsigned int steps);
+	void SetFrameRateLimit(unsigned int frames_per_second);
+	void SetNetworkMode(NetworkMode mode);
+	//Writes a row of timings and render counters for every presented frame, throws if the file cannot be opened
+	void SetStatisticsCsv(const std::string& filename);
 
 private:
 	void ProcessInput();
 	void Update(sf::Time delta_time);
-	void Render();
+	void Render(float alpha);
+	void Close();
 	void UpdateStatistics(sf::Time elapsed_time);
 	void RegisterStates();
 
 private:
 	sf::RenderWindow m_window;
+	RenderThread m_render_thread;
 
 	TextureHolder m_textures;
 	FontHolder m_fonts;
@@ -34,6 +48,10 @@ private:
 
 	KeyBinding m_key_binding_1;
 	KeyBinding m_key_binding_2;
+	//Used by the games this application hosts
+	NetworkMode m_network_mode;
+	//Shared by every World the states create
+	JobSystem m_job_system;
 
 	StateStack m_stack;
 
@@ -41,6 +59,21 @@ private:
 	sf::Time m_statistics_updatetime;
 
 	std::size_t m_statistics_numframes;
-	static const sf::Time kTimePerFrame;
+	std::size_t m_statistics_numupdates;
+	std::size_t m_statistics_allocations;
+	std::size_t m_statistics_sprites;
+	std::size_t m_statistics_glyphs;
+	RenderStatistics m_render_statistics;
+	std::vector<FrameSample> m_frame_samples;
+	//Time spent in Update since the last frame was recorded
+	sf::Time m_frame_update_time;
+
+	sf::Time m_time_per_update;
+	unsigned int m_max_catch_up_steps;
+	sf::Time m_min_time_per_frame;
+	static const unsigned int kDefaultSimulationFrequency;
+	static const unsigned int kMaxSimulationFrequency;
+	static const unsigned int kDefaultMaxCatchUpSteps;
+	static const unsigned int kDefaultFrameRateLimit;
 };
 
@@ -0,0 +1,988 @@
+#include "Benchmark.hpp"
+
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Animator.hpp"
+#include "BroadphaseGrid.hpp"
+#include "JobSystem.hpp"
+#include "ParticleNode.hpp"
+#include "Player.hpp"
+#include "Fixed.hpp"
+#include "Random.hpp"
+#include "RenderSnapshot.hpp"
+#include "RenderStatistics.hpp"
+#include "RollbackSession.hpp"
+#include "ResourceHolder.hpp"
+#include "SimMath.hpp"
+#include "SimdKernels.hpp"
+#include "TextNode.hpp"
+#include "TripleBuffer.hpp"
+#include "Utility.hpp"
+#include "World.hpp"
+
+namespace
+{
+	const std::size_t kElementCount = 1 << 16;
+	const int kRepetitions = 200;
+
+	std::vector<float> MakeValues(std::size_t count, float low, float high, unsigned int seed)
+	{
+		std::mt19937 engine(seed);
+		std::uniform_real_distribution<float> distribution(low, high);
+		std::vector<float> values(count);
+		for (float& value : values)
+		{
+			value = distribution(engine);
+		}
+		return values;
+	}
+
+	void Report(const std::string& name, const char* variant, sf::Time time, std::size_t operations)
+	{
+		double nanoseconds = time.asMicroseconds() * 1000.0 / static_cast<double>(operations);
+		std::cout << std::left << std::setw(24) << name << std::setw(10) << variant
+			<< std::right << std::fixed << std::setprecision(3) << std::setw(10) << nanoseconds << " ns/op" << std::endl;
+	}
+
+	std::vector<SimdLevel> GetLevels()
+	{
+		std::vector<SimdLevel> levels;
+		for (int level = 0; level <= static_cast<int>(SimdKernels::GetSupportedLevel()); ++level)
+		{
+			levels.emplace_back(static_cast<SimdLevel>(level));
+		}
+		return levels;
+	}
+
+	bool BenchmarkIntegrate()
+	{
+		const std::vector<float> start = MakeValues(kElementCount * 2, 0.f, 1920.f, 1);
+		const std::vector<float> velocities = MakeValues(kElementCount * 2, -500.f, 500.f, 2);
+		std::vector<float> weights(kElementCount * 2, 1.f);
+		for (std::size_t i = 0; i < weights.size(); i += 14)
+		{
+			//Roughly one in seven entities frozen
+			weights[i] = weights[i + 1] = 0.f;
+		}
+
+		bool matches = true;
+		std::vector<float> expected;
+		for (SimdLevel level : GetLevels())
+		{
+			SimdKernels::SetLevel(level);
+			std::vector<float> positions = start;
+			sf::Clock clock;
+			for (int repetition = 0; repetition < kRepetitions; ++repetition)
+			{
+				SimdKernels::Integrate(positions.data(), velocities.data(), weights.data(), positions.size(), 1.f / 60.f);
+			}
+			//One operation per component, each entity integrates its x and its y
+			Report("Integrate", SimdKernels::GetLevelName(level), clock.getElapsedTime(), positions.size() * kRepetitions);
+
+			if (expected.empty())
+			{
+				expected = positions;
+			}
+			matches = matches && positions == expected;
+		}
+		return matches;
+	}
+
+	bool BenchmarkFindOverlaps()
+	{
+		const std::size_t box_count = 4096;
+		const std::vector<float> min_x = MakeValues(box_count, 0.f, 1920.f, 3);
+		const std::vector<float> min_y = MakeValues(box_count, 0.f, 1080.f, 4);
+		const std::vector<float> size = MakeValues(box_count, 8.f, 64.f, 5);
+		std::vector<float> max_x(box_count);
+		std::vector<float> max_y(box_count);
+		for (std::size_t i = 0; i < box_count; ++i)
+		{
+			max_x[i] = min_x[i] + size[i];
+			max_y[i] = min_y[i] + size[i];
+		}
+		AabbArrays boxes = { min_x.data(), min_y.data(), max_x.data(), max_y.data() };
+		std::vector<std::uint32_t> found(box_count);
+
+		bool matches = true;
+		std::uint64_t expected = 0;
+		for (SimdLevel level : GetLevels())
+		{
+			SimdKernels::SetLevel(level);
+			//Same all pairs sweep EntityStore::FindCollisionPairs does, the checksum catches differing or reordered results
+			std::uint64_t checksum = 0;
+			sf::Clock clock;
+			for (std::size_t i = 0; i < box_count; ++i)
+			{
+				std::size_t count = SimdKernels::FindOverlaps(boxes, i + 1, box_count, min_x[i], min_y[i], max_x[i], max_y[i], found.data());
+				for (std::size_t k = 0; k < count; ++k)
+				{
+					checksum = checksum * 31 + found[k];
+				}
+			}
+			Report("FindOverlaps", SimdKernels::GetLevelName(level), clock.getElapsedTime(), box_count * (box_count - 1) / 2);
+
+			if (level == SimdLevel::kScalar)
+			{
+				expected = checksum;
+			}
+			matches = matches && checksum == expected;
+		}
+		return matches;
+	}
+
+	bool BenchmarkFindNearest()
+	{
+		const std::size_t target_count = 1024;
+		const std::size_t query_count = 4096;
+		const std::vector<float> xs = MakeValues(target_count, 0.f, 1920.f, 6);
+		const std::vector<float> ys = MakeValues(target_count, 0.f, 1080.f, 7);
+		const std::vector<float> query_x = MakeValues(query_count, 0.f, 1920.f, 8);
+		const std::vector<float> query_y = MakeValues(query_count, 0.f, 1080.f, 9);
+
+		bool matches = true;
+		std::vector<std::size_t> expected;
+		for (SimdLevel level : GetLevels())
+		{
+			SimdKernels::SetLevel(level);
+			std::vector<std::size_t> nearest(query_count);
+			sf::Clock clock;
+			for (std::size_t i = 0; i < query_count; ++i)
+			{
+				float distance_squared;
+				nearest[i] = SimdKernels::FindNearest(xs.data(), ys.data(), target_count, sf::Vector2f(query_x[i], query_y[i]), distance_squared);
+			}
+			Report("FindNearest", SimdKernels::GetLevelName(level), clock.getElapsedTime(), query_count * target_count);
+
+			if (expected.empty())
+			{
+				expected = nearest;
+			}
+			matches = matches && nearest == expected;
+		}
+		return matches;
+	}
+
+	//The grid narrowphase has to give exactly the pairs of the all pairs sweep, whatever the number of threads
+	bool BenchmarkBroadphase()
+	{
+		const std::size_t box_count = 4096;
+		const std::vector<float> min_x = MakeValues(box_count, 0.f, 1920.f, 12);
+		const std::vector<float> min_y = MakeValues(box_count, 0.f, 1080.f, 13);
+		const std::vector<float> size = MakeValues(box_count, 8.f, 64.f, 14);
+		std::vector<float> max_x(box_count);
+		std::vector<float> max_y(box_count);
+		for (std::size_t i = 0; i < box_count; ++i)
+		{
+			max_x[i] = min_x[i] + size[i];
+			max_y[i] = min_y[i] + size[i];
+		}
+
+		AabbArrays boxes = { min_x.data(), min_y.data(), max_x.data(), max_y.data() };
+		std::vector<std::uint32_t> found(box_count);
+		std::vector<BroadphaseGrid::IndexPair> expected;
+		sf::Clock clock;
+		for (std::size_t i = 0; i < box_count; ++i)
+		{
+			std::size_t count = SimdKernels::FindOverlaps(boxes, i + 1, box_count, min_x[i], min_y[i], max_x[i], max_y[i], found.data());
+			for (std::size_t k = 0; k < count; ++k)
+			{
+				expected.emplace_back(static_cast<std::uint32_t>(i), found[k]);
+			}
+		}
+		Report("Broadphase", "all pairs", clock.getElapsedTime(), box_count);
+
+		//Reject some pairs so the filter is checked as well
+		auto filter = [](std::uint32_t first, std::uint32_t second)
+		{
+			return (first + second) % 5 != 0;
+		};
+		expected.erase(std::remove_if(expected.begin(), expected.end(), [&filter](const BroadphaseGrid::IndexPair& pair)
+		{
+			return !filter(pair.first, pair.second);
+		}), expected.end());
+
+		bool matches = true;
+		const unsigned int worker_counts[] = { 0, 1, JobSystem::GetDefaultWorkerCount() };
+		for (unsigned int workers : worker_counts)
+		{
+			JobSystem jobs(workers);
+			BroadphaseGrid grid(128.f);
+			std::vector<BroadphaseGrid::IndexPair> pairs;
+			clock.restart();
+			for (int repetition = 0; repetition < kRepetitions; ++repetition)
+			{
+				grid.Clear();
+				for (std::size_t i = 0; i < box_count; ++i)
+				{
+					grid.Insert(static_cast<std::uint32_t>(i), min_x[i], min_y[i], max_x[i], max_y[i]);
+				}
+				grid.Build();
+				grid.FindPairs(jobs, filter, pairs);
+				matches = matches && pairs == expected;
+			}
+			const std::string variant = std::to_string(workers + 1) + " thr";
+			Report("Broadphase grid", variant.c_str(), clock.getElapsedTime(), box_count * kRepetitions);
+		}
+		return matches;
+	}
+
+	//Compares the grid against a plain loop over every pair, on boxes that sit on cell borders, at negative
+	//coordinates, far outside the clamped grid range or have NaN bounds, with each number of threads
+	bool CheckBroadphase()
+	{
+		const float cell_size = 64.f;
+		const float far = 1.0e9f;
+		const float nan = std::numeric_limits<float>::quiet_NaN();
+		std::vector<float> min_x = MakeValues(1024, -2000.f, 2000.f, 30);
+		std::vector<float> min_y = MakeValues(1024, -2000.f, 2000.f, 31);
+		std::vector<float> size = MakeValues(1024, 1.f, 200.f, 32);
+		std::vector<float> max_x(min_x.size());
+		std::vector<float> max_y(min_y.size());
+		for (std::size_t i = 0; i < min_x.size(); ++i)
+		{
+			//Every fourth box is moved onto a cell border
+			if (i % 4 == 0)
+			{
+				min_x[i] = std::floor(min_x[i] / cell_size) * cell_size;
+			}
+			max_x[i] = min_x[i] + size[i];
+			max_y[i] = min_y[i] + size[i];
+		}
+
+		const float special[][4] =
+		{
+			{ 0.f, 0.f, cell_size, cell_size },
+			{ cell_size, 0.f, 2.f * cell_size, cell_size },
+			{ -cell_size, -cell_size, 0.f, 0.f },
+			{ far, far, far + 10.f, far + 10.f },
+			{ far + 5.f, far + 5.f, far + 20.f, far + 20.f },
+			{ -far - 10.f, -far - 10.f, -far, -far },
+			{ -far - 5.f, -far - 5.f, -far + 5.f, -far + 5.f },
+			{ -std::numeric_limits<float>::max(), 0.f, std::numeric_limits<float>::max(), 10.f },
+			{ nan, 0.f, 10.f, 10.f },
+			{ 0.f, 0.f, nan, nan },
+			{ nan, nan, nan, nan },
+		};
+		for (const float* box : special)
+		{
+			min_x.emplace_back(box[0]);
+			min_y.emplace_back(box[1]);
+			max_x.emplace_back(box[2]);
+			max_y.emplace_back(box[3]);
+		}
+
+		const std::size_t box_count = min_x.size();
+		std::vector<BroadphaseGrid::IndexPair> expected;
+		for (std::size_t i = 0; i < box_count; ++i)
+		{
+			for (std::size_t j = i + 1; j < box_count; ++j)
+			{
+				if (min_x[j] < max_x[i] && min_x[i] < max_x[j] && min_y[j] < max_y[i] && min_y[i] < max_y[j])
+				{
+					expected.emplace_back(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j));
+				}
+			}
+		}
+
+		bool matches = true;
+		const unsigned int worker_counts[] = { 0, 1, JobSystem::GetDefaultWorkerCount() };
+		for (unsigned int workers : worker_counts)
+		{
+			JobSystem jobs(workers);
+			BroadphaseGrid grid(cell_size);
+			for (std::size_t i = 0; i < box_count; ++i)
+			{
+				grid.Insert(static_cast<std::uint32_t>(i), min_x[i], min_y[i], max_x[i], max_y[i]);
+			}
+			grid.Build();
+			std::vector<BroadphaseGrid::IndexPair> pairs;
+			grid.FindPairs(jobs, [](std::uint32_t, std::uint32_t) { return true; }, pairs);
+			matches = matches && pairs == expected;
+		}
+		std::cout << "Broadphase check: " << expected.size() << " pairs, " << (matches ? "match" : "MISMATCH") << std::endl;
+		return matches;
+	}
+
+	//One peer of a rollback match: a headless World, the players that steer it and its session
+	struct RollbackPeer
+	{
+		RollbackPeer(JobSystem& jobs, sf::Time tick_time)
+			: m_world(sf::Vector2f(1920.f, 1080.f), jobs)
+			, m_session(m_world, tick_time, [this](int identifier, RollbackSession::Input input, CommandQueue& commands)
+			{
+				m_players[identifier - 1]->ApplyInput(input, commands);
+			})
+		{
+			for (int identifier = 1; identifier <= 2; ++identifier)
+			{
+				m_players.emplace_back(new Player(nullptr, identifier, nullptr));
+				m_world.AddAircraft(identifier, identifier == 1);
+			}
+			m_world.StartGame();
+		}
+
+		World m_world;
+		RollbackSession m_session;
+		std::vector<std::unique_ptr<Player>> m_players;
+		std::map<RollbackSession::Tick, std::uint32_t> m_checksums;
+	};
+
+	struct InputMessage
+	{
+		int m_delivery_step;
+		int m_identifier;
+		RollbackSession::Tick m_tick;
+		RollbackSession::Input m_input;
+	};
+
+	//Player 1 plays on the first peer and player 2 on the second, each sees the other's input a few ticks late
+	//Input that changes while it is in flight is mispredicted and rolled back, yet both peers must checksum
+	//the same states as a reference peer that knew every input in time, and a wrong checksum must be noticed
+	bool CheckRollback()
+	{
+		const int step_count = 600;
+		const int latency = 5;
+		const sf::Time tick_time = sf::seconds(1.f / 60.f);
+		auto script = [](int identifier, int step)
+		{
+			//Holds every input for a while, player 2 changes its mind at different times than player 1
+			const int phase = (step + identifier * 7) / (9 + identifier * 4);
+			return static_cast<RollbackSession::Input>((phase * 37 + identifier) & 0x3f);
+		};
+
+		JobSystem jobs;
+		RollbackPeer reference(jobs, tick_time);
+		reference.m_session.AddPlayer(1, true);
+		reference.m_session.AddPlayer(2, true);
+		std::unique_ptr<RollbackPeer> peers[2] = { std::unique_ptr<RollbackPeer>(new RollbackPeer(jobs, tick_time)), std::unique_ptr<RollbackPeer>(new RollbackPeer(jobs, tick_time)) };
+		for (int peer = 0; peer < 2; ++peer)
+		{
+			peers[peer]->m_session.AddPlayer(1, peer == 0);
+			peers[peer]->m_session.AddPlayer(2, peer == 1);
+		}
+
+		std::deque<InputMessage> in_flight[2];
+		for (int step = 0; step < step_count; ++step)
+		{
+			for (int identifier = 1; identifier <= 2; ++identifier)
+			{
+				reference.m_session.AddLocalInput(identifier, script(identifier, step));
+			}
+			reference.m_session.Advance();
+			RollbackSession::Tick tick;
+			std::uint32_t checksum;
+			while (reference.m_session.PollChecksum(tick, checksum))
+			{
+				reference.m_checksums[tick] = checksum;
+			}
+
+			for (int peer = 0; peer < 2; ++peer)
+			{
+				RollbackPeer& local = *peers[peer];
+				RollbackPeer& remote = *peers[1 - peer];
+				while (!in_flight[peer].empty() && in_flight[peer].front().m_delivery_step <= step)
+				{
+					const InputMessage& message = in_flight[peer].front();
+					local.m_session.AddRemoteInput(message.m_identifier, message.m_tick, message.m_input);
+					in_flight[peer].pop_front();
+				}
+				if (!local.m_session.CanAdvance())
+				{
+					continue;
+				}
+
+				const int identifier = peer + 1;
+				const RollbackSession::Input input = script(identifier, step);
+				InputMessage message = { step + latency, identifier, local.m_session.AddLocalInput(identifier, input), input };
+				in_flight[1 - peer].emplace_back(message);
+				local.m_session.Advance();
+
+				while (local.m_session.PollChecksum(tick, checksum))
+				{
+					local.m_checksums[tick] = checksum;
+					remote.m_session.CheckRemoteChecksum(tick, checksum);
+				}
+			}
+		}
+
+		bool matches = !reference.m_session.HasDesynced();
+		std::size_t compared = 0;
+		for (const std::unique_ptr<RollbackPeer>& peer : peers)
+		{
+			matches = matches && !peer->m_session.HasDesynced() && peer->m_session.GetResimulatedTicks() > 0;
+			for (const auto& checksum : peer->m_checksums)
+			{
+				auto expected = reference.m_checksums.find(checksum.first);
+				matches = matches && expected != reference.m_checksums.end() && expected->second == checksum.second;
+				++compared;
+			}
+		}
+		matches = matches && compared > 0;
+		if (peers[1]->m_checksums.empty())
+		{
+			std::cout << "Rollback check: no ticks were confirmed" << std::endl;
+			return false;
+		}
+
+		//A peer reporting a different checksum for a tick this one has confirmed means the simulations drifted apart
+		auto last = peers[1]->m_checksums.rbegin();
+		peers[1]->m_session.CheckRemoteChecksum(last->first, last->second ^ 1u);
+		matches = matches && peers[1]->m_session.HasDesynced() && !peers[0]->m_session.HasDesynced();
+		//So does an input that skips ticks, the ones in between can never be simulated
+		peers[0]->m_session.AddRemoteInput(2, peers[0]->m_session.GetCurrentTick() + 1000, 0);
+		matches = matches && peers[0]->m_session.HasDesynced();
+
+		std::cout << "Rollback check: " << compared << " checksums, " << peers[0]->m_session.GetResimulatedTicks() + peers[1]->m_session.GetResimulatedTicks()
+			<< " ticks resimulated, " << (matches ? "match" : "MISMATCH") << std::endl;
+		return matches;
+	}
+
+	//The game's font, loaded for real so the text checks lay out actual glyphs. Returns false when it is missing
+	bool LoadGameFont(FontHolder& fonts)
+	{
+		try
+		{
+			fonts.Load(Fonts::Main, "Media/Fonts/Sansation.ttf");
+		}
+		catch (const std::runtime_error& error)
+		{
+			std::cout << error.what() << std::endl;
+			return false;
+		}
+		RenderSnapshot::PreloadGlyphs(fonts.Get(Fonts::Main), 20);
+		return true;
+	}
+
+	//Every label recorded on its own must come out as one quad per visible character, covering what sf::Text
+	//measures plus the pixel of padding both put around each glyph. Kerned pairs, line breaks, letter spacing
+	//and labels that are moved, scaled, mirrored or centred the way TextNode centres them all have to line up
+	bool CheckTextLayout()
+	{
+		FontHolder fonts;
+		if (!LoadGameFont(fonts))
+		{
+			return false;
+		}
+
+		const char* strings[] = { "Score: 1200", "AVAJ To Ty", "Player 2 wins!", "Wave\n3", "|_~{}" };
+		RenderSnapshot snapshot;
+		bool matches = true;
+		std::size_t glyphs = 0;
+		for (const char* string : strings)
+		{
+			for (int variant = 0; variant < 3; ++variant)
+			{
+				sf::Text text(string, fonts.Get(Fonts::Main), 20);
+				text.setPosition(37.f, 412.f);
+				if (variant == 1)
+				{
+					text.setScale(2.f, 0.5f);
+					text.setLetterSpacing(1.5f);
+				}
+				else if (variant == 2)
+				{
+					Utility::CentreOrigin(text);
+					text.setScale(-1.f, 1.f);
+				}
+
+				snapshot.Clear(sf::View());
+				snapshot.Draw(text);
+
+				//sf::Text measures the glyphs unpadded, so its bounds grow by the padding on each side
+				const sf::FloatRect local = text.getLocalBounds();
+				const sf::FloatRect padded(local.left - 1.f, local.top - 1.f, local.width + 2.f, local.height + 2.f);
+				const sf::FloatRect expected = text.getTransform().transformRect(padded);
+				const sf::FloatRect bounds = snapshot.GetVertexBounds();
+				const float tolerance = 0.01f;
+				matches = matches && std::abs(bounds.left - expected.left) < tolerance && std::abs(bounds.top - expected.top) < tolerance
+					&& std::abs(bounds.width - expected.width) < tolerance && std::abs(bounds.height - expected.height) < tolerance;
+
+				const std::string characters(string);
+				const std::size_t visible = characters.size() - std::count_if(characters.begin(), characters.end(), [](char c) { return c == ' ' || c == '\n'; });
+				matches = matches && snapshot.GetGlyphCount() == visible && snapshot.GetDrawCallCount() == 1;
+				glyphs += snapshot.GetGlyphCount();
+			}
+		}
+		std::cout << "Text layout check: " << glyphs << " glyphs, " << (matches ? "match" : "MISMATCH") << std::endl;
+		return matches;
+	}
+
+	//A publish the consumer never picked up is reported and handed back as the back buffer, so its frame
+	//times can be carried on instead of lost
+	bool CheckTripleBuffer()
+	{
+		TripleBuffer<int> buffer;
+		buffer.GetBack() = 1;
+		bool matches = !buffer.Publish();
+		buffer.GetBack() = 2;
+		matches = matches && buffer.Publish() && buffer.GetBack() == 1;
+		matches = matches && buffer.Acquire() && buffer.GetFront() == 2 && !buffer.Acquire();
+		buffer.GetBack() = 3;
+		matches = matches && !buffer.Publish();
+		std::cout << "Triple buffer check: " << (matches ? "match" : "MISMATCH") << std::endl;
+		return matches;
+	}
+
+	struct Check
+	{
+		const char* m_name;
+		bool (*m_function)();
+	};
+
+	const Check kChecks[] =
+	{
+		{ "broadphase", &CheckBroadphase },
+		{ "rollback", &CheckRollback },
+		{ "text", &CheckTextLayout },
+		{ "triplebuffer", &CheckTripleBuffer },
+	};
+
+	bool BenchmarkLength()
+	{
+		const std::vector<float> xs = MakeValues(kElementCount, -1000.f, 1000.f, 10);
+		const std::vector<float> ys = MakeValues(kElementCount, -1000.f, 1000.f, 11);
+
+		//The formula Utility::Length used before, kept here as the baseline
+		float baseline_sum = 0.f;
+		sf::Clock clock;
+		for (std::size_t i = 0; i < kElementCount; ++i)
+		{
+			baseline_sum += sqrtf(powf(xs[i], 2) + powf(ys[i], 2));
+		}
+		Report("Utility::Length", "powf", clock.getElapsedTime(), kElementCount);
+
+		float sum = 0.f;
+		clock.restart();
+		for (std::size_t i = 0; i < kElementCount; ++i)
+		{
+			sum += Utility::Length(sf::Vector2f(xs[i], ys[i]));
+		}
+		Report("Utility::Length", "multiply", clock.getElapsedTime(), kElementCount);
+
+		return std::abs(sum - baseline_sum) <= std::abs(baseline_sum) * 1e-5f;
+	}
+
+	//Draw cost against the engine Utility::RandomInt used before, and whether a stream restored from its state repeats itself
+	bool BenchmarkRandom()
+	{
+		const std::size_t draw_count = kElementCount * 16;
+
+		//The engine and distribution Utility::RandomInt used before, kept here as the baseline
+		std::default_random_engine engine(1);
+		std::uniform_int_distribution<> distribution(0, 5);
+		int baseline_sum = 0;
+		sf::Clock clock;
+		for (std::size_t i = 0; i < draw_count; ++i)
+		{
+			baseline_sum += distribution(engine);
+		}
+		Report("RandomInt", "default_random_engine", clock.getElapsedTime(), draw_count);
+
+		Random random(1);
+		const Random::State start = random.GetState();
+		int sum = 0;
+		clock.restart();
+		for (std::size_t i = 0; i < draw_count; ++i)
+		{
+			sum += random.NextInt(6);
+		}
+		Report("RandomInt", "xoshiro128**", clock.getElapsedTime(), draw_count);
+
+		random.SetState(start);
+		int replayed_sum = 0;
+		for (std::size_t i = 0; i < draw_count; ++i)
+		{
+			replayed_sum += random.NextInt(6);
+		}
+		//Both draw uniformly from [0, 6), so their means only differ by noise
+		const double expected = draw_count * 2.5;
+		return replayed_sum == sum && std::abs(sum - expected) < expected * 0.01 && std::abs(baseline_sum - expected) < expected * 0.01;
+	}
+
+	//Guided projectile steering, a unit vector and an angle per projectile as in Projectile::UpdateCurrent, in float and in Fixed
+	template <typename Scalar>
+	Scalar SteerAll(const std::vector<float>& xs, const std::vector<float>& ys)
+	{
+		Scalar sum = Scalar(0.f);
+		for (std::size_t i = 0; i < xs.size(); ++i)
+		{
+			sf::Vector2<Scalar> direction = SimMath::UnitVector(sf::Vector2<Scalar>(Scalar(xs[i]), Scalar(ys[i])));
+			sum += SimMath::Atan2(direction.y, direction.x);
+		}
+		return sum;
+	}
+
+	bool BenchmarkFixedPoint()
+	{
+		std::cout << "Simulation maths: " << SimMath::GetModeName() << std::endl;
+		const std::vector<float> xs = MakeValues(kElementCount, 1.f, 1000.f, 12);
+		const std::vector<float> ys = MakeValues(kElementCount, -1000.f, 1000.f, 13);
+
+		sf::Clock clock;
+		const float float_sum = SteerAll<float>(xs, ys);
+		Report("Steering", "float", clock.getElapsedTime(), kElementCount);
+		clock.restart();
+		const Fixed fixed_sum = SteerAll<Fixed>(xs, ys);
+		Report("Steering", "Fixed", clock.getElapsedTime(), kElementCount);
+
+		std::vector<float> float_positions = xs;
+		std::vector<float> fixed_positions = xs;
+		const std::vector<float> weights(kElementCount, 1.f);
+		clock.restart();
+		for (int repetition = 0; repetition < kRepetitions; ++repetition)
+		{
+			for (std::size_t i = 0; i < kElementCount; ++i)
+			{
+				float_positions[i] += ys[i] * weights[i] * (1.f / 60.f);
+			}
+		}
+		Report("Integrate", "float", clock.getElapsedTime(), kElementCount * kRepetitions);
+		const Fixed step(1.f / 60.f);
+		clock.restart();
+		for (int repetition = 0; repetition < kRepetitions; ++repetition)
+		{
+			for (std::size_t i = 0; i < kElementCount; ++i)
+			{
+				fixed_positions[i] = (Fixed(fixed_positions[i]) + Fixed(ys[i]) * Fixed(weights[i]) * step).ToFloat();
+			}
+		}
+		Report("Integrate", "Fixed", clock.getElapsedTime(), kElementCount * kRepetitions);
+
+		//Fixed rounds differently, so the two only agree to within its precision
+		//A 1/60 step rounds to a multiple of 2^-16, moving everything about 0.03% slower than float does,
+		//and both round to the nearest float each step, which can fall on different sides
+		bool matches = std::abs(fixed_sum.ToFloat() - float_sum) <= kElementCount * 1e-4f;
+		for (std::size_t i = 0; i < kElementCount; ++i)
+		{
+			const float travelled = std::abs(ys[i]) * kRepetitions / 60.f;
+			matches = matches && std::abs(fixed_positions[i] - float_positions[i]) <= travelled * 1e-3f + kRepetitions * 1e-3f;
+		}
+		return matches;
+	}
+
+	//Records a match in progress the way the game does each frame and counts the draw calls it turns into
+	bool BenchmarkSpriteBatching()
+	{
+		JobSystem jobs;
+		World world(sf::Vector2f(1920.f, 1080.f), jobs);
+		//A full match, so each team's sprites have something to batch with
+		for (int identifier = 1; identifier <= 8; ++identifier)
+		{
+			world.AddAircraft(identifier, identifier % 2 == 0);
+		}
+		world.StartGame();
+		for (int tick = 0; tick < 600; ++tick)
+		{
+			world.Update(sf::seconds(1.f / 60.f));
+		}
+
+		RenderSnapshot snapshot;
+		sf::Clock clock;
+		for (int repetition = 0; repetition < kRepetitions; ++repetition)
+		{
+			snapshot.Clear(sf::View());
+			world.Draw(snapshot);
+		}
+		Report("World::Draw", "record", clock.getElapsedTime(), kRepetitions);
+		std::cout << "Draw calls: " << snapshot.GetDrawCallCount() << " for " << snapshot.GetSpriteCount() << " sprites" << std::endl;
+		const bool sprites_joined = snapshot.GetDrawCallCount() < snapshot.GetSpriteCount();
+
+		//A sprite drawn after a label must not join the sprites with its texture from before the label
+		FontHolder fonts;
+		if (!LoadGameFont(fonts))
+		{
+			return false;
+		}
+		sf::Texture texture;
+		sf::Sprite sprite(texture);
+		sf::Text label("Score", fonts.Get(Fonts::Main), 20);
+		snapshot.Clear(sf::View());
+		snapshot.BeginSpriteBatch();
+		snapshot.Draw(sprite);
+		snapshot.Draw(label);
+		snapshot.Draw(sprite);
+		snapshot.EndSpriteBatch();
+		return sprites_joined && snapshot.GetDrawCallCount() == 3;
+	}
+
+	//Labels sharing a font and size are drawn from its glyph atlas in one call, and unchanged strings cost nothing to set
+	bool BenchmarkTextBatching()
+	{
+		const std::size_t label_count = 64;
+		FontHolder fonts;
+		if (!LoadGameFont(fonts))
+		{
+			return false;
+		}
+		std::vector<sf::Text> labels(label_count, sf::Text("Player 1", fonts.Get(Fonts::Main), 20));
+		for (std::size_t i = 0; i < label_count; ++i)
+		{
+			labels[i].setPosition(static_cast<float>(i % 8) * 200.f, static_cast<float>(i / 8) * 100.f);
+		}
+
+		RenderSnapshot snapshot;
+		sf::Clock clock;
+		for (int repetition = 0; repetition < kRepetitions; ++repetition)
+		{
+			snapshot.Clear(sf::View());
+			snapshot.BeginSpriteBatch();
+			for (const sf::Text& label : labels)
+			{
+				snapshot.Draw(label);
+			}
+			snapshot.EndSpriteBatch();
+		}
+		Report("Text 64 labels", "record", clock.getElapsedTime(), kRepetitions * label_count);
+
+		TextNode node(fonts, "");
+		clock.restart();
+		for (std::size_t i = 0; i < kRepetitions * label_count; ++i)
+		{
+			node.SetString("Player 1");
+		}
+		Report("TextNode::SetString", "same", clock.getElapsedTime(), kRepetitions * label_count);
+
+		std::cout << "Draw calls: " << snapshot.GetDrawCallCount() << " for " << snapshot.GetGlyphCount() << " glyphs" << std::endl;
+		return snapshot.GetDrawCallCount() == 1;
+	}
+
+	//Playing a walk cycle on a crowd of sprites, every sprite must land on the frame its clip gives for the time played
+	bool BenchmarkAnimator()
+	{
+		const std::size_t sprite_count = 1024;
+		const int tick_count = 600;
+		const sf::Time dt = sf::seconds(1.f / 60.f);
+		const AnimationClip clip(sf::IntRect(0, 64, 32, 32), 6, 192, sf::milliseconds(250), true);
+		std::vector<sf::Sprite> sprites(sprite_count);
+		Animator animator;
+		for (sf::Sprite& sprite : sprites)
+		{
+			animator.SetPlaying(animator.Add(sprite, clip), true);
+		}
+
+		sf::Clock clock;
+		for (int tick = 0; tick < tick_count; ++tick)
+		{
+			animator.Update(dt);
+		}
+		Report("Animator", "update", clock.getElapsedTime(), sprite_count * tick_count);
+
+		const sf::IntRect& expected = clip.GetFrame(clip.GetFrameAt(dt * static_cast<float>(tick_count)));
+		bool matches = true;
+		for (const sf::Sprite& sprite : sprites)
+		{
+			matches = matches && sprite.getTextureRect() == expected;
+		}
+		return matches;
+	}
+
+	//The overlay's rolling window, with 1 to 100 microseconds in it the p99 is the second largest
+	bool BenchmarkTimingWindow()
+	{
+		TimingWindow window(100);
+		//Overfill it so the first ten samples have been pushed out again
+		for (int sample = -9; sample <= 100; ++sample)
+		{
+			window.Add(sf::microseconds(std::max(sample, 1)));
+		}
+		std::cout << "Timing window: min " << window.GetMin().asMicroseconds() << "us, avg " << window.GetAverage().asMicroseconds()
+			<< "us, p99 " << window.GetPercentile(0.99f).asMicroseconds() << "us" << std::endl;
+		return window.GetSize() == 100 && window.GetMin() == sf::microseconds(1) && window.GetAverage() == sf::microseconds(50)
+			&& window.GetPercentile(0.99f) == sf::microseconds(99);
+	}
+
+	//Ticking and building the vertices of 100k particles a frame, as the old ParticleNode did it and with the ring buffer
+	bool BenchmarkParticles()
+	{
+		const std::size_t particle_count = 100000;
+		const int frame_count = 20;
+		const sf::Time dt = sf::seconds(1.f / 60.f);
+		const std::vector<float> xs = MakeValues(particle_count, 0.f, 1920.f, 14);
+		const std::vector<float> ys = MakeValues(particle_count, 0.f, 1080.f, 15);
+		TextureHolder textures;
+		textures.LoadEmpty(Textures::kParticle);
+
+		//The old ParticleNode, kept here as the baseline: a deque, lifetimes counted down and vertices appended one at a time
+		struct DequeParticle
+		{
+			sf::Vector2f m_position;
+			sf::Color m_colour;
+			sf::Time m_lifetime;
+		};
+		std::deque<DequeParticle> deque_particles;
+		for (std::size_t i = 0; i < particle_count; ++i)
+		{
+			deque_particles.push_back({ sf::Vector2f(xs[i], ys[i]), sf::Color::White, sf::seconds(4.f) });
+		}
+		sf::VertexArray deque_vertices(sf::TriangleStrip);
+		sf::Clock clock;
+		for (int frame = 0; frame < frame_count; ++frame)
+		{
+			for (DequeParticle& particle : deque_particles)
+			{
+				particle.m_lifetime -= dt;
+			}
+			deque_vertices.clear();
+			for (const DequeParticle& particle : deque_particles)
+			{
+				sf::Color colour = particle.m_colour;
+				colour.a = static_cast<sf::Uint8>(255 * std::max(particle.m_lifetime.asSeconds() / 4.f, 0.f));
+				deque_vertices.append(sf::Vertex(particle.m_position + sf::Vector2f(-4.f, -4.f), colour, sf::Vector2f(0.f, 0.f)));
+				deque_vertices.append(sf::Vertex(particle.m_position + sf::Vector2f(4.f, -4.f), colour, sf::Vector2f(8.f, 0.f)));
+				deque_vertices.append(sf::Vertex(particle.m_position + sf::Vector2f(4.f, 4.f), colour, sf::Vector2f(8.f, 8.f)));
+				deque_vertices.append(sf::Vertex(particle.m_position + sf::Vector2f(-4.f, 4.f), colour, sf::Vector2f(0.f, 8.f)));
+			}
+		}
+		Report("Particles 100k", "deque", clock.getElapsedTime(), particle_count * frame_count);
+
+		bool matches = true;
+		const sf::FloatRect view_bounds(-100.f, -100.f, 2120.f, 1280.f);
+		const unsigned int worker_counts[] = { 0, JobSystem::GetDefaultWorkerCount() };
+		for (unsigned int workers : worker_counts)
+		{
+			JobSystem jobs(workers);
+			ParticleNode particles(ParticleType::kSmoke, textures, jobs, particle_count);
+			for (std::size_t i = 0; i < particle_count; ++i)
+			{
+				particles.AddParticle(sf::Vector2f(xs[i], ys[i]));
+			}
+
+			RenderSnapshot snapshot;
+			CommandQueue commands;
+			clock.restart();
+			for (int frame = 0; frame < frame_count; ++frame)
+			{
+				particles.Update(dt, commands);
+				snapshot.Clear(sf::View());
+				particles.UpdateDrawBounds(sf::Transform::Identity);
+				particles.Draw(snapshot, sf::RenderStates::Default, view_bounds);
+			}
+			const std::string variant = "ring " + std::to_string(workers + 1) + " thr";
+			Report("Particles 100k", variant.c_str(), clock.getElapsedTime(), particle_count * frame_count);
+			matches = matches && particles.GetParticleCount() == particle_count && snapshot.GetDrawCallCount() == 1;
+		}
+		return matches;
+	}
+
+	bool SameState(const WorldState& first, const WorldState& second)
+	{
+		return first.GetSize() == second.GetSize() && std::memcmp(first.GetData(), second.GetData(), first.GetSize()) == 0;
+	}
+
+	//Startup and tick cost of a world with no window, textures or audio behind it,
+	//then the cost of saving and restoring its state and whether a restored world replays the same ticks
+	bool BenchmarkHeadlessWorld()
+	{
+		const int tick_count = 600;
+		sf::Clock clock;
+		JobSystem jobs;
+		World world(sf::Vector2f(1920.f, 1080.f), jobs);
+		Report("Headless World", "startup", clock.getElapsedTime(), 1);
+
+		world.AddAircraft(1, true);
+		world.AddAircraft(2, false);
+		world.StartGame();
+		clock.restart();
+		for (int tick = 0; tick < tick_count; ++tick)
+		{
+			world.Update(sf::seconds(1.f / 60.f));
+		}
+		Report("Headless World", "tick", clock.getElapsedTime(), tick_count);
+
+		WorldState start;
+		clock.restart();
+		for (int repetition = 0; repetition < kRepetitions; ++repetition)
+		{
+			world.SaveState(start);
+		}
+		Report("World::SaveState", "", clock.getElapsedTime(), kRepetitions);
+		clock.restart();
+		for (int repetition = 0; repetition < kRepetitions; ++repetition)
+		{
+			world.RestoreState(start);
+		}
+		Report("World::RestoreState", "", clock.getElapsedTime(), kRepetitions);
+		std::cout << "World state: " << start.GetSize() << " bytes" << std::endl;
+
+		//Commands left queued between ticks are not part of a saved state, rollback mode carries them out within the tick
+		world.SetRollback(true);
+		WorldState first_run;
+		WorldState second_run;
+		for (WorldState* run : { &first_run, &second_run })
+		{
+			world.RestoreState(start);
+			for (int tick = 0; tick < tick_count; ++tick)
+			{
+				world.Update(sf::seconds(1.f / 60.f));
+			}
+			world.SaveState(*run);
+		}
+		return SameState(first_run, second_run);
+	}
+}
+
+int Benchmark::Run()
+{
+	std::cout << "Supported SIMD level: " << SimdKernels::GetLevelName(SimdKernels::GetSupportedLevel()) << std::endl;
+
+	bool matches = true;
+	matches = BenchmarkIntegrate() && matches;
+	matches = BenchmarkFindOverlaps() && matches;
+	matches = BenchmarkFindNearest() && matches;
+	matches = BenchmarkBroadphase() && matches;
+	for (const Check& check : kChecks)
+	{
+		matches = check.m_function() && matches;
+	}
+	matches = BenchmarkLength() && matches;
+	matches = BenchmarkRandom() && matches;
+	matches = BenchmarkFixedPoint() && matches;
+	matches = BenchmarkHeadlessWorld() && matches;
+	matches = BenchmarkSpriteBatching() && matches;
+	matches = BenchmarkTextBatching() && matches;
+	matches = BenchmarkAnimator() && matches;
+	matches = BenchmarkTimingWindow() && matches;
+	matches = BenchmarkParticles() && matches;
+
+	SimdKernels::SetLevel(SimdKernels::GetSupportedLevel());
+	std::cout << (matches ? "All kernels match the scalar results" : "MISMATCH between kernel variants") << std::endl;
+	return matches ? 0 : 1;
+}
+
+int Benchmark::RunCheck(const std::string& name)
+{
+	for (const Check& check : kChecks)
+	{
+		if (name == check.m_name)
+		{
+			return check.m_function() ? 0 : 1;
+		}
+	}
+	std::cout << "Unknown check " << name << ", available:";
+	for (const Check& check : kChecks)
+	{
+		std::cout << " " << check.m_name;
+	}
+	std::cout << std::endl;
+	return 1;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+
+//Microbenchmarks for the simulation hot paths, run with the --benchmark command line switch
+//Every kernel is timed at each SIMD level the CPU supports and its output is checked against the scalar version
+//The collision broadphase is timed with different thread counts and checked against the all pairs sweep
+//A headless World is built and ticked to time startup and a simulation step without rendering or audio,
+//its state is saved and restored and the replayed ticks must end in the same state as the first run
+//Two rollback peers exchanging late input must checksum the same states as one that knew every input in time
+//Text recorded with the game's font must cover what sf::Text measures, one quad per visible character
+//The correctness checks also run on their own, without any timing, with --check <name>
+class Benchmark
+{
+public:
+	//Returns 0 when every result matched, 1 otherwise
+	static int Run();
+	//Runs the correctness check called name, returns 0 when it passed and 1 when it failed or does not exist
+	static int RunCheck(const std::string& name);
+};
@@ -0,0 +1,141 @@
+#include "BroadphaseGrid.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	//Cells further out than this are folded onto the outermost ones, which only merges far away cells,
+	//boxes that overlap still always share a cell
+	const float kMaxCellCoordinate = static_cast<float>(1 << 12);
+
+	//Clamped before the conversion, so NaN and huge coordinates cannot overflow the integer
+	std::int32_t ToCell(float coordinate, float cell_size)
+	{
+		float cell = std::floor(coordinate / cell_size);
+		if (!(cell >= -kMaxCellCoordinate))
+		{
+			cell = -kMaxCellCoordinate;
+		}
+		else if (cell > kMaxCellCoordinate)
+		{
+			cell = kMaxCellCoordinate;
+		}
+		return static_cast<std::int32_t>(cell);
+	}
+
+	//Negative cell coordinates wrap around, which keeps keys unique as long as the grid is under 2^32 cells across
+	std::uint64_t MakeCellKey(std::int32_t x, std::int32_t y)
+	{
+		return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(y)) << 32) | static_cast<std::uint32_t>(x);
+	}
+}
+
+BroadphaseGrid::BroadphaseGrid(float cell_size)
+	: m_cell_size(cell_size)
+	, m_largest_cell(0)
+{
+	assert(cell_size > 0.f);
+}
+
+void BroadphaseGrid::Clear()
+{
+	m_boxes.clear();
+	m_entries.clear();
+	m_cells.clear();
+	m_largest_cell = 0;
+}
+
+//Each index may only be inserted once between calls to Clear
+void BroadphaseGrid::Insert(std::uint32_t index, float min_x, float min_y, float max_x, float max_y)
+{
+	const std::uint32_t box = static_cast<std::uint32_t>(m_boxes.size());
+	Box bounds = { min_x, min_y, max_x, max_y };
+	m_boxes.emplace_back(bounds);
+
+	const std::int32_t first_x = ToCell(min_x, m_cell_size);
+	const std::int32_t first_y = ToCell(min_y, m_cell_size);
+	const std::int32_t last_x = ToCell(max_x, m_cell_size);
+	const std::int32_t last_y = ToCell(max_y, m_cell_size);
+	for (std::int32_t y = first_y; y <= last_y; ++y)
+	{
+		for (std::int32_t x = first_x; x <= last_x; ++x)
+		{
+			Entry entry = { MakeCellKey(x, y), index, box };
+			m_entries.emplace_back(entry);
+		}
+	}
+}
+
+void BroadphaseGrid::Build()
+{
+	//Group the entries by cell, and by index within a cell so the lower index of a pair always comes first
+	std::sort(m_entries.begin(), m_entries.end(), [](const Entry& lhs, const Entry& rhs)
+	{
+		return lhs.m_cell < rhs.m_cell || (lhs.m_cell == rhs.m_cell && lhs.m_index < rhs.m_index);
+	});
+
+	const std::size_t count = m_entries.size();
+	m_min_x.resize(count);
+	m_min_y.resize(count);
+	m_max_x.resize(count);
+	m_max_y.resize(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const Box& box = m_boxes[m_entries[i].m_box];
+		m_min_x[i] = box.m_min_x;
+		m_min_y[i] = box.m_min_y;
+		m_max_x[i] = box.m_max_x;
+		m_max_y[i] = box.m_max_y;
+	}
+
+	m_cells.clear();
+	m_largest_cell = 0;
+	std::uint32_t begin = 0;
+	while (begin < count)
+	{
+		std::uint32_t end = begin + 1;
+		while (end < count && m_entries[end].m_cell == m_entries[begin].m_cell)
+		{
+			++end;
+		}
+		if (end - begin > 1)
+		{
+			Cell cell = { begin, end };
+			m_cells.emplace_back(cell);
+			m_largest_cell = std::max(m_largest_cell, end - begin);
+		}
+		begin = end;
+	}
+}
+
+std::size_t BroadphaseGrid::GetCellCount() const
+{
+	return m_cells.size();
+}
+
+void BroadphaseGrid::PrepareThreadBuffers(std::size_t thread_count)
+{
+	if (m_thread_buffers.size() < thread_count)
+	{
+		m_thread_buffers.resize(thread_count);
+	}
+	for (ThreadBuffer& buffer : m_thread_buffers)
+	{
+		buffer.m_pairs.clear();
+		buffer.m_overlaps.resize(m_largest_cell);
+	}
+}
+
+//Two boxes that share several cells are found once in each of them, sorting brings the copies together
+void BroadphaseGrid::MergeThreadBuffers(std::vector<IndexPair>& pairs)
+{
+	pairs.clear();
+	for (const ThreadBuffer& buffer : m_thread_buffers)
+	{
+		pairs.insert(pairs.end(), buffer.m_pairs.begin(), buffer.m_pairs.end());
+	}
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "SimdKernels.hpp"
+
+class JobSystem;
+
+//Uniform grid over axis aligned boxes, used to find overlapping pairs without testing every box against every other
+//A box goes into every cell it touches, the boxes sharing a cell are then tested against each other
+//Cells are independent, so FindPairs spreads them over the JobSystem. Each thread collects into its own buffer,
+//and the buffers are merged, sorted and deduplicated afterwards, so the result never depends on how cells were scheduled
+class BroadphaseGrid : private sf::NonCopyable
+{
+public:
+	//Lower index first, pairs come out sorted by first then second index
+	typedef std::pair<std::uint32_t, std::uint32_t> IndexPair;
+
+public:
+	explicit BroadphaseGrid(float cell_size);
+
+	void Clear();
+	void Insert(std::uint32_t index, float min_x, float min_y, float max_x, float max_y);
+	//Call after the last Insert and before FindPairs
+	void Build();
+	std::size_t GetCellCount() const;
+
+	//Every pair of inserted boxes that overlap, and for which filter(first, second) returns true
+	//Boxes that only touch do not overlap, matching SimdKernels::FindOverlaps
+	template <typename Filter>
+	void FindPairs(JobSystem& jobs, const Filter& filter, std::vector<IndexPair>& pairs);
+
+private:
+	struct Box
+	{
+		float m_min_x;
+		float m_min_y;
+		float m_max_x;
+		float m_max_y;
+	};
+
+	struct Entry
+	{
+		std::uint64_t m_cell;
+		std::uint32_t m_index;
+		std::uint32_t m_box;
+	};
+
+	//Range of m_entries sharing one cell
+	struct Cell
+	{
+		std::uint32_t m_begin;
+		std::uint32_t m_end;
+	};
+
+	struct ThreadBuffer
+	{
+		std::vector<IndexPair> m_pairs;
+		std::vector<std::uint32_t> m_overlaps;
+	};
+
+private:
+	void PrepareThreadBuffers(std::size_t thread_count);
+	void MergeThreadBuffers(std::vector<IndexPair>& pairs);
+
+private:
+	float m_cell_size;
+	std::vector<Box> m_boxes;
+	std::vector<Entry> m_entries;
+	//Boxes copied out in entry order, so the boxes of a cell are contiguous for the overlap kernel
+	std::vector<float> m_min_x;
+	std::vector<float> m_min_y;
+	std::vector<float> m_max_x;
+	std::vector<float> m_max_y;
+	//Only cells with at least two boxes, the others cannot hold a pair
+	std::vector<Cell> m_cells;
+	std::uint32_t m_largest_cell;
+	std::vector<ThreadBuffer> m_thread_buffers;
+};
+
+#include "BroadphaseGrid.inl"
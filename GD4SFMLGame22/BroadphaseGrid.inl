@@ -0,0 +1,36 @@
+#include "JobSystem.hpp"
+
+template <typename Filter>
+void BroadphaseGrid::FindPairs(JobSystem& jobs, const Filter& filter, std::vector<IndexPair>& pairs)
+{
+	//Cells hold a handful of boxes each, hand them out a few dozen at a time
+	const std::size_t cell_grain_size = 32;
+
+	PrepareThreadBuffers(jobs.GetWorkerCount() + 1);
+	AabbArrays boxes = { m_min_x.data(), m_min_y.data(), m_max_x.data(), m_max_y.data() };
+
+	jobs.ParallelFor(m_cells.size(), cell_grain_size, [&](std::size_t begin, std::size_t end)
+	{
+		ThreadBuffer& buffer = m_thread_buffers[jobs.GetThreadIndex()];
+		for (std::size_t c = begin; c < end; ++c)
+		{
+			const Cell& cell = m_cells[c];
+			for (std::uint32_t a = cell.m_begin; a < cell.m_end; ++a)
+			{
+				std::size_t found = SimdKernels::FindOverlaps(boxes, a + 1, cell.m_end, m_min_x[a], m_min_y[a], m_max_x[a], m_max_y[a], buffer.m_overlaps.data());
+				for (std::size_t k = 0; k < found; ++k)
+				{
+					//Entries of a cell are sorted by index, so the first one is always the lower index
+					std::uint32_t first = m_entries[a].m_index;
+					std::uint32_t second = m_entries[buffer.m_overlaps[k]].m_index;
+					if (filter(first, second))
+					{
+						buffer.m_pairs.emplace_back(first, second);
+					}
+				}
+			}
+		}
+	});
+
+	MergeThreadBuffers(pairs);
+}
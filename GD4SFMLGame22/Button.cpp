@@ -3,8 +3,7 @@
 #include "ResourceHolder.hpp"
 #include "Utility.hpp"
 
-#include <SFML/Graphics/RenderStates.hpp>
-#include <SFML/Graphics/RenderTarget.hpp>
+#include "RenderSnapshot.hpp"
 
 #include "ButtonType.hpp"
 
@@ -94,11 +93,11 @@ namespace GUI
 	{
 	}
 
-	void Button::draw(sf::RenderTarget& target, sf::RenderStates states) const
+	void Button::Draw(RenderSnapshot& snapshot, sf::RenderStates states) const
 	{
 		states.transform *= getTransform();
-		target.draw(m_sprite, states);
-		target.draw(m_text, states);
+		snapshot.Draw(m_sprite, states);
+		snapshot.Draw(m_text, states);
 	}
 
 	void Button::ChangeTexture(ButtonType buttonType)
@@ -33,9 +33,9 @@ namespace GUI
 		virtual void Activate() override;
 		virtual void Deactivate() override;
 		virtual void HandleEvent(const sf::Event& event) override;
+		virtual void Draw(RenderSnapshot& snapshot, sf::RenderStates states) const override;
 
 	private:
-		virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 		void ChangeTexture(ButtonType buttonType);
 
 	private:
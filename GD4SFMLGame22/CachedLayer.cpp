@@ -0,0 +1,72 @@
+#include "CachedLayer.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+
+#include <cassert>
+
+CachedLayer::CachedLayer()
+	: m_valid(false)
+	, m_version(0)
+	, m_rendered_version(0)
+	, m_texture_available(false)
+{
+}
+
+bool CachedLayer::IsValid(const sf::View& view) const
+{
+	//Rotated views are drawn uncached, the image is only ever an axis aligned quad
+	return m_valid && view.getRotation() == 0.f && view.getCenter() == m_view.getCenter() && view.getSize() == m_view.getSize();
+}
+
+void CachedLayer::Invalidate()
+{
+	m_valid = false;
+}
+
+void CachedLayer::Draw(sf::RenderTarget& target, const sf::RenderStates& states) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_version == 0)
+	{
+		return;
+	}
+	//One texel for every pixel the layer covers on the target, however many world units the view spans
+	const sf::IntRect viewport = target.getViewport(target.getView());
+	const sf::Vector2u pixel_size(static_cast<unsigned int>(viewport.width), static_cast<unsigned int>(viewport.height));
+	if (m_rendered_version != m_version || (m_texture_available && m_texture.getSize() != pixel_size))
+	{
+		Render(pixel_size);
+	}
+
+	if (!m_texture_available)
+	{
+		//Replay changes the view, put back the one the target was using
+		const sf::View view = target.getView();
+		m_contents.Overlay(target);
+		target.setView(view);
+		return;
+	}
+
+	//The image covers exactly what the view showed when it was recorded
+	const sf::Vector2f size = m_view.getSize();
+	const sf::Vector2u texture_size = m_texture.getSize();
+	sf::Sprite image(m_texture.getTexture());
+	image.setPosition(m_view.getCenter() - size / 2.f);
+	image.setScale(size.x / texture_size.x, size.y / texture_size.y);
+	target.draw(image, states);
+}
+
+void CachedLayer::Render(const sf::Vector2u& size) const
+{
+	m_rendered_version = m_version;
+	if (m_texture.getSize() != size || !m_texture_available)
+	{
+		m_texture_available = size.x > 0 && size.y > 0 && m_texture.create(size.x, size.y);
+	}
+	if (m_texture_available)
+	{
+		m_contents.Replay(m_texture);
+		m_texture.display();
+	}
+}
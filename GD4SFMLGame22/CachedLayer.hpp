@@ -0,0 +1,52 @@
+#pragma once
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <mutex>
+
+#include "RenderSnapshot.hpp"
+
+namespace sf
+{
+	class RenderTarget;
+}
+
+//A layer that does not change, drawn each frame as one quad textured with an image of it
+//The simulation thread records the layer into the cache's own snapshot, seen through the view it is drawn with.
+//The render thread plays that recording into a render texture the first time it draws the cache and only draws
+//the texture after that. The texture matches the pixels the view covers on the target and is rendered again
+//when those change size. A different view, or Invalidate, makes IsValid fail until the layer is recorded again
+//Where render textures are not available the recording is played straight onto the target every frame
+class CachedLayer : private sf::NonCopyable
+{
+public:
+	CachedLayer();
+
+	bool IsValid(const sf::View& view) const;
+	void Invalidate();
+	//Calls record with the snapshot to draw the layer into, holding the lock until it returns or throws
+	//A recording that throws leaves the cache invalid, so the layer is recorded again next frame
+	template <typename Recorder>
+	void Record(const sf::View& view, const Recorder& record);
+
+	void Draw(sf::RenderTarget& target, const sf::RenderStates& states) const;
+
+private:
+	void Render(const sf::Vector2u& size) const;
+
+private:
+	//Held while recording on one side and rendering on the other, both only happen when the cache is refreshed
+	mutable std::mutex m_mutex;
+	RenderSnapshot m_contents;
+	sf::View m_view;
+	bool m_valid;
+	unsigned int m_version;
+
+	mutable sf::RenderTexture m_texture;
+	mutable unsigned int m_rendered_version;
+	mutable bool m_texture_available;
+};
+
+#include "CachedLayer.inl"
@@ -0,0 +1,11 @@
+template <typename Recorder>
+void CachedLayer::Record(const sf::View& view, const Recorder& record)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_view = view;
+	m_view.setViewport(sf::FloatRect(0.f, 0.f, 1.f, 1.f));
+	m_contents.Clear(m_view, sf::Color::Transparent);
+	record(m_contents);
+	m_valid = true;
+	++m_version;
+}
@@ -1,7 +1,11 @@
 #include "Command.hpp"
+
+const int Command::kNoTarget = -1;
+
 Command::Command()
 	: action()
 	, category(Category::kNone)
+	, target_identifier(kNoTarget)
 {
 	
 }
@@ -8,9 +8,14 @@ class SceneNode;
 
 struct Command
 {
+	//target_identifier of a command that is broadcast through the scene graph by category
+	static const int kNoTarget;
+
 	Command();
 	std::function<void(SceneNode&, sf::Time)> action;
 	unsigned int category;
+	//When set, World hands the command straight to the aircraft with this identifier instead of broadcasting it
+	int target_identifier;
 };
 
 template<typename GameObject, typename Function>
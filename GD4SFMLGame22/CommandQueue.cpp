@@ -1,18 +1,31 @@
 #include "CommandQueue.hpp"
 
+CommandQueue::CommandQueue()
+	: m_queue()
+	, m_front(0)
+{
+}
+
 void CommandQueue::Push(const Command& command)
 {
-	m_queue.push(command);
+	m_queue.push_back(command);
 }
 
 Command CommandQueue::Pop()
 {
-	Command command = m_queue.front();
-	m_queue.pop();
+	Command command = std::move(m_queue[m_front]);
+	++m_front;
+
+	//Queue drained, rewind but keep the capacity for the next frame
+	if (m_front == m_queue.size())
+	{
+		m_queue.clear();
+		m_front = 0;
+	}
 	return command;
 }
 
 bool CommandQueue::IsEmpty() const
 {
-	return m_queue.empty();
+	return m_front == m_queue.size();
 }
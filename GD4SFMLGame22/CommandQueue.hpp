@@ -1,15 +1,19 @@
 #pragma once
 #include "Command.hpp"
-#include <queue>
+#include <vector>
 // TODO Make CommandQueue class a Singleton
+//Commands are kept in a vector that is only cleared once it has been drained,
+//so the storage is reused every frame instead of allocating a node per command
 class CommandQueue
 {
 public:
+	CommandQueue();
 	void Push(const Command& command);
 	Command Pop();
 	bool IsEmpty() const;
 
 private:
-	std::queue<Command> m_queue;
+	std::vector<Command> m_queue;
+	std::size_t m_front;
 };
 
@@ -1,6 +1,6 @@
 #pragma once
 #include <SFML/System/NonCopyable.hpp>
-#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/Transformable.hpp>
 #include <memory>
 //TODO consider how we are including files - can we tidy this up?
@@ -8,9 +8,11 @@ namespace sf
 {
 	class Event;
 }
+class RenderSnapshot;
+
 namespace GUI
 {
-	class Component : public sf::Drawable, public sf::Transformable, private sf::NonCopyable
+	class Component : public sf::Transformable, private sf::NonCopyable
 	{
 	public:
 		typedef std::shared_ptr<Component> Ptr;
@@ -28,6 +30,7 @@ namespace GUI
 		virtual void Deactivate();
 
 		virtual void HandleEvent(const sf::Event& event) = 0;
+		virtual void Draw(RenderSnapshot& snapshot, sf::RenderStates states) const = 0;
 
 	private:
 		bool m_is_selected;
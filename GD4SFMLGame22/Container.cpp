@@ -1,8 +1,8 @@
 #include "Container.hpp"
 
 #include <SFML/Window/Event.hpp>
-#include <SFML/Graphics/RenderStates.hpp>
-#include <SFML/Graphics/RenderTarget.hpp>
+
+#include "RenderSnapshot.hpp"
 
 namespace GUI
 {
@@ -52,12 +52,12 @@ namespace GUI
 		}
 	}
 
-	void Container::draw(sf::RenderTarget& target, sf::RenderStates states) const
+	void Container::Draw(RenderSnapshot& snapshot, sf::RenderStates states) const
 	{
 		states.transform *= getTransform();
 		for(const Component::Ptr& child : m_children)
 		{
-			target.draw(*child, states);
+			child->Draw(snapshot, states);
 		}
 
 	}
@@ -15,9 +15,9 @@ namespace GUI
 		void Pack(Component::Ptr component);
 		virtual bool IsSelectable() const override;
 		virtual void HandleEvent(const sf::Event& event) override;
+		virtual void Draw(RenderSnapshot& snapshot, sf::RenderStates states) const override;
 
 	private:
-		virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
 		bool HasSelection() const;
 		void Select(std::size_t index);
 		void SelectNext();
@@ -17,6 +17,7 @@ std::vector<AircraftData> InitializeAircraftData()
 	data[static_cast<int>(AircraftType::kTeamPink)].m_throw_texture_rect = sf::IntRect(0, 96 , 32, 32);
 	data[static_cast<int>(AircraftType::kTeamPink)].m_has_roll_animation = true;
 	data[static_cast<int>(AircraftType::kTeamPink)].m_walk_animation_frames = 6;
+	data[static_cast<int>(AircraftType::kTeamPink)].m_walk_frame_time = sf::milliseconds(250);
 	data[static_cast<int>(AircraftType::kTeamPink)].m_throw_animation_frames = 4;
 
 	data[static_cast<int>(AircraftType::kTeamBlue)].m_hitpoints = 100;
@@ -27,6 +28,7 @@ std::vector<AircraftData> InitializeAircraftData()
 	data[static_cast<int>(AircraftType::kTeamBlue)].m_throw_texture_rect = sf::IntRect(0, 32, 32, 32);
 	data[static_cast<int>(AircraftType::kTeamBlue)].m_has_roll_animation = true;
 	data[static_cast<int>(AircraftType::kTeamBlue)].m_walk_animation_frames = 6;
+	data[static_cast<int>(AircraftType::kTeamBlue)].m_walk_frame_time = sf::milliseconds(250);
 	data[static_cast<int>(AircraftType::kTeamBlue)].m_throw_animation_frames = 4;
 
 	data[static_cast<int>(AircraftType::kRaptor)].m_hitpoints = 20;
@@ -54,6 +56,19 @@ std::vector<AircraftData> InitializeAircraftData()
 	data[static_cast<int>(AircraftType::kAvenger)].m_directions.emplace_back(Direction(0.f, 50.f));
 	data[static_cast<int>(AircraftType::kAvenger)].m_directions.emplace_back(Direction(+45.f, 50.f));
 	data[static_cast<int>(AircraftType::kAvenger)].m_has_roll_animation = false;
+
+	//Frame rects are laid out here once rather than worked out while the animations play
+	for (AircraftData& aircraft : data)
+	{
+		if (aircraft.m_has_roll_animation)
+		{
+			const sf::IntRect& walk = aircraft.m_walk_texture_rect;
+			const int sheet_width = walk.left + walk.width * aircraft.m_walk_animation_frames;
+			aircraft.m_walk_animation = AnimationClip(walk, aircraft.m_walk_animation_frames, sheet_width, aircraft.m_walk_frame_time, true);
+		}
+		//Splatter.png is a single row of 14 frames of 100x100 played over a second
+		aircraft.m_splatter_animation = AnimationClip(sf::IntRect(0, 0, 100, 100), 14, 1400, sf::seconds(1.f) / 14.f, false);
+	}
 	return data;
 }
 
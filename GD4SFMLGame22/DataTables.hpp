@@ -5,6 +5,7 @@
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Time.hpp>
 
+#include "AnimationClip.hpp"
 #include "ResourceIdentifiers.hpp"
 
 class Aircraft;
@@ -32,6 +33,10 @@ struct AircraftData
 	bool m_has_roll_animation;
 	int m_throw_animation_frames;
 	int m_walk_animation_frames;
+	sf::Time m_walk_frame_time;
+	//Built from the fields above once the table is filled in
+	AnimationClip m_walk_animation;
+	AnimationClip m_splatter_animation;
 };
 
 struct ProjectileData
@@ -12,6 +12,14 @@ EmitterNode::EmitterNode(ParticleType type)
 {
 }
 
+void EmitterNode::Reset(ParticleType type)
+{
+	ResetTransform();
+	m_accumulated_time = sf::Time::Zero;
+	m_type = type;
+	m_particle_system = nullptr;
+}
+
 void EmitterNode::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 {
 	if (m_particle_system)
@@ -7,6 +7,7 @@ class EmitterNode : public SceneNode
 {
 public:
 	explicit EmitterNode(ParticleType type);
+	void Reset(ParticleType type);
 
 
 private:
@@ -1,43 +1,213 @@
 #include "Entity.hpp"
 
+#include <cassert>
 #include <iostream>
 #include <ostream>
 
+#include "SimMath.hpp"
+
 Entity::Entity(int hitpoints)
-	: m_hitpoints(hitpoints)
+	: m_velocity()
+	, m_hitpoints(hitpoints)
+	, m_store(nullptr)
+	, m_store_index(0)
+	, m_handle()
+{
+}
+
+Entity::~Entity()
+{
+	Unregister();
+}
+
+//Hand movement and bounds over to the store, from now on the store integrates this entity
+void Entity::Register(EntityStore& store, unsigned int flags)
+{
+	assert(!m_store);
+	m_store = &store;
+	m_store_index = store.Add(*this, getPosition(), m_velocity, flags);
+	UpdateDestroyedState();
+}
+
+void Entity::Unregister()
+{
+	if (m_store)
+	{
+		m_velocity = m_store->GetVelocity(m_store_index);
+		m_store->Remove(m_store_index);
+		m_store = nullptr;
+	}
+}
+
+bool Entity::IsRegistered() const
+{
+	return m_store != nullptr;
+}
+
+//Null until the entity is registered with a store
+EntityHandle Entity::GetHandle() const
+{
+	return m_handle;
+}
+
+void Entity::setPosition(float x, float y)
+{
+	setPosition(sf::Vector2f(x, y));
+}
+
+void Entity::setPosition(const sf::Vector2f& position)
+{
+	SceneNode::setPosition(position);
+	if (m_store)
+	{
+		m_store->SetPosition(m_store_index, position);
+	}
+}
+
+//Like setPosition, but the change is treated as movement, so it is swept for collisions and interpolated when drawn
+void Entity::TravelTo(sf::Vector2f position)
+{
+	SceneNode::setPosition(position);
+	if (m_store)
+	{
+		m_store->SetPosition(m_store_index, position, true);
+	}
+}
+
+void Entity::move(float offset_x, float offset_y)
+{
+	move(sf::Vector2f(offset_x, offset_y));
+}
+
+void Entity::move(const sf::Vector2f& offset)
 {
+	setPosition(getPosition() + offset);
+}
+
+void Entity::setRotation(float angle)
+{
+	SceneNode::setRotation(angle);
+	MarkBoundsDirty();
+}
+
+void Entity::setScale(float factor_x, float factor_y)
+{
+	SceneNode::setScale(factor_x, factor_y);
+	MarkBoundsDirty();
+}
+
+void Entity::setScale(const sf::Vector2f& factors)
+{
+	setScale(factors.x, factors.y);
 }
 
 void Entity::SetVelocity(sf::Vector2f velocity)
 {
-	m_velocity = velocity;
+	if (m_store)
+	{
+		m_store->SetVelocity(m_store_index, velocity);
+	}
+	else
+	{
+		m_velocity = velocity;
+	}
 }
 
 void Entity::SetVelocity(float vx, float vy)
 {
-	m_velocity.x = vx;
-	m_velocity.y = vy;
+	SetVelocity(sf::Vector2f(vx, vy));
 }
 
 sf::Vector2f Entity::GetVelocity() const
 {
+	if (m_store)
+	{
+		return m_store->GetVelocity(m_store_index);
+	}
 	return m_velocity;
 }
 
 void Entity::Accelerate(sf::Vector2f velocity)
 {
-	m_velocity += velocity;
+	SetVelocity(GetVelocity() + velocity);
 }
 
 void Entity::Accelerate(float vx, float vy)
 {
-	m_velocity.x += vx;
-	m_velocity.y += vy;
+	Accelerate(sf::Vector2f(vx, vy));
+}
+
+//Bring a pooled entity back to the state it was constructed in
+void Entity::Reset(int hitpoints)
+{
+	assert(!m_store);
+	ResetTransform();
+	m_velocity = sf::Vector2f();
+	m_hitpoints = hitpoints;
+}
+
+void Entity::MarkBoundsDirty()
+{
+	if (m_store)
+	{
+		m_store->MarkBoundsDirty(m_store_index);
+	}
 }
 
 void Entity::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 {
-	move(m_velocity * dt.asSeconds());
+	//Registered entities are moved by EntityStore::Integrate
+	if (!m_store)
+	{
+		const sf::Vector2f mobility(1.f, 1.f);
+		sf::Vector2f position = getPosition();
+		SimMath::Integrate(&position.x, &m_velocity.x, &mobility.x, 2, dt.asSeconds());
+		SceneNode::setPosition(position);
+	}
+}
+
+void Entity::OnDispose()
+{
+	//A disposed entity may sit in a pool for a while, it must not keep being integrated
+	Unregister();
+}
+
+void Entity::SyncPosition(sf::Vector2f position)
+{
+	SceneNode::setPosition(position);
+}
+
+//Destroyed entities stay where they are, as they did when UpdateCurrent skipped moving them,
+//and are queued so the store can dispose of them once they are marked for removal
+void Entity::UpdateDestroyedState()
+{
+	if (m_store)
+	{
+		m_store->SetFlag(m_store_index, EntityStore::kFrozen, IsDestroyed());
+		if (IsDestroyed())
+		{
+			m_store->QueueRemoval(m_store_index);
+		}
+	}
+}
+
+//Transform, velocity and hitpoints. The position is placed rather than travelled, nothing is swept or interpolated across a restore
+void Entity::SaveState(WorldState& state) const
+{
+	state.Write(getPosition());
+	state.Write(getRotation());
+	state.Write(getScale());
+	state.Write(GetVelocity());
+	state.Write(m_hitpoints);
+}
+
+void Entity::RestoreState(WorldState::Reader& state)
+{
+	setPosition(state.Read<sf::Vector2f>());
+	setRotation(state.Read<float>());
+	setScale(state.Read<sf::Vector2f>());
+	SetVelocity(state.Read<sf::Vector2f>());
+	SetHitpoints(state.Read<int>());
 }
 
 int Entity::GetHitPoints() const
@@ -49,12 +219,14 @@ void Entity::SetHitpoints(int points)
 {
 	//assert(points > 0);
 	m_hitpoints = points;
+	UpdateDestroyedState();
 }
 
 void Entity::Repair(unsigned int points)
 {
 	assert(points > 0);
 	m_hitpoints += points;
+	UpdateDestroyedState();
 }
 
 void Entity::Damage(int points)
@@ -62,11 +234,13 @@ void Entity::Damage(int points)
 	//assert(points > 0);
 	m_hitpoints -= points;
 	//std::cout << "After damage: " << m_hitpoints << std::endl;
+	UpdateDestroyedState();
 }
 
 void Entity::Destroy()
 {
 	m_hitpoints = 0;
+	UpdateDestroyedState();
 }
 
 bool Entity::IsDestroyed() const
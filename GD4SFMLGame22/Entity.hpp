@@ -1,11 +1,31 @@
 #pragma once
 #include "CommandQueue.hpp"
+#include "EntityStore.hpp"
 #include "SceneNode.hpp"
+#include "WorldState.hpp"
 
 class Entity : public SceneNode
 {
+	friend class EntityStore;
+
 public:
 	Entity(int hitpoints);
+	virtual ~Entity();
+
+	void Register(EntityStore& store, unsigned int flags = EntityStore::kNone);
+	void Unregister();
+	bool IsRegistered() const;
+	EntityHandle GetHandle() const;
+
+	//Hide the sf::Transformable setters so a registered entity keeps its store slot in step with the node
+	void setPosition(float x, float y);
+	void setPosition(const sf::Vector2f& position);
+	void move(float offset_x, float offset_y);
+	void move(const sf::Vector2f& offset);
+	void setRotation(float angle);
+	void setScale(float factor_x, float factor_y);
+	void setScale(const sf::Vector2f& factors);
+	void TravelTo(sf::Vector2f position);
 	void SetVelocity(sf::Vector2f velocity);
 	void SetVelocity(float vx, float vy);
 	void Accelerate(sf::Vector2f velocity);
@@ -20,10 +40,23 @@ public:
 	void Destroy();
 	virtual bool IsDestroyed() const override;
 
+	virtual void SaveState(WorldState& state) const;
+	virtual void RestoreState(WorldState::Reader& state);
+
 protected:
+	void Reset(int hitpoints);
+	void MarkBoundsDirty();
 	virtual void UpdateCurrent(sf::Time dt, CommandQueue& commands);
+	virtual void OnDispose() override;
+
+private:
+	void SyncPosition(sf::Vector2f position);
+	void UpdateDestroyedState();
 
 private:
 	sf::Vector2f m_velocity;
 	int m_hitpoints;
+	EntityStore* m_store;
+	EntityStore::Index m_store_index;
+	EntityHandle m_handle;
 };
\ No newline at end of file
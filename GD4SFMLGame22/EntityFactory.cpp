@@ -0,0 +1,68 @@
+#include "EntityFactory.hpp"
+
+namespace
+{
+	//Every World starts from the same seed so peers simulating one match roll the same dice,
+	//Random::Seed spreads it over the whole state so any value will do
+	const std::uint64_t kRandomSeed = 0;
+}
+
+EntityFactory::EntityFactory(const TextureHolder& textures, EntityStore& store)
+	: m_textures(textures)
+	, m_store(store)
+	, m_random(kRandomSeed)
+{
+}
+
+std::unique_ptr<Aircraft> EntityFactory::CreateAircraft(AircraftType type, const FontHolder* fonts)
+{
+	std::unique_ptr<Aircraft> aircraft(new Aircraft(type, m_textures, fonts, *this));
+	aircraft->Register(m_store);
+	return aircraft;
+}
+
+std::unique_ptr<Projectile> EntityFactory::CreateProjectile(ProjectileType type)
+{
+	std::unique_ptr<Projectile> projectile = m_projectile_pool.Acquire(type, m_textures);
+	projectile->Register(m_store, EntityStore::kCullOutsideView | EntityStore::kContinuous);
+
+	// Add particle system for missiles
+	if (projectile->IsGuided())
+	{
+		std::unique_ptr<EmitterNode> smoke = CreateEmitter(ParticleType::kSmoke);
+		smoke->setPosition(0.f, projectile->GetBoundingRect().height / 2.f);
+		projectile->AttachChild(std::move(smoke));
+
+		std::unique_ptr<EmitterNode> propellant = CreateEmitter(ParticleType::kPropellant);
+		propellant->setPosition(0.f, projectile->GetBoundingRect().height / 2.f);
+		projectile->AttachChild(std::move(propellant));
+	}
+	return projectile;
+}
+
+std::unique_ptr<Pickup> EntityFactory::CreatePickup(PickupType type, int index)
+{
+	std::unique_ptr<Pickup> pickup = m_pickup_pool.Acquire(type, m_textures, index);
+	pickup->Register(m_store);
+	return pickup;
+}
+
+std::unique_ptr<EmitterNode> EntityFactory::CreateEmitter(ParticleType type)
+{
+	return m_emitter_pool.Acquire(type);
+}
+
+Random& EntityFactory::GetRandom()
+{
+	return m_random;
+}
+
+const Random& EntityFactory::GetRandom() const
+{
+	return m_random;
+}
+
+Animator& EntityFactory::GetAnimator()
+{
+	return m_animator;
+}
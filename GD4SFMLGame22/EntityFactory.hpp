@@ -0,0 +1,48 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+
+#include <memory>
+
+#include "Aircraft.hpp"
+#include "AircraftType.hpp"
+#include "Animator.hpp"
+#include "EmitterNode.hpp"
+#include "EntityStore.hpp"
+#include "ObjectPool.hpp"
+#include "ParticleType.hpp"
+#include "Pickup.hpp"
+#include "PickupType.hpp"
+#include "Projectile.hpp"
+#include "Random.hpp"
+#include "ProjectileType.hpp"
+#include "ResourceIdentifiers.hpp"
+
+//Creates the short lived entities of a World from per type pools
+//Nodes are returned to their pool when SceneNode::RemoveWrecks disposes of them,
+//so heavy throwing reuses the same objects instead of going back to the heap
+//Every entity it creates is registered with the EntityStore that moves it
+class EntityFactory : private sf::NonCopyable
+{
+public:
+	EntityFactory(const TextureHolder& textures, EntityStore& store);
+
+	std::unique_ptr<Aircraft> CreateAircraft(AircraftType type, const FontHolder* fonts);
+	std::unique_ptr<Projectile> CreateProjectile(ProjectileType type);
+	std::unique_ptr<Pickup> CreatePickup(PickupType type, int index);
+	std::unique_ptr<EmitterNode> CreateEmitter(ParticleType type);
+
+	//The World's own random stream, entities roll their dice here so the outcome is part of the saved state
+	Random& GetRandom();
+	const Random& GetRandom() const;
+	//Plays the animations of the entities it creates, it outlives them as the factory does
+	Animator& GetAnimator();
+
+private:
+	const TextureHolder& m_textures;
+	EntityStore& m_store;
+	ObjectPool<Projectile> m_projectile_pool;
+	ObjectPool<Pickup> m_pickup_pool;
+	ObjectPool<EmitterNode> m_emitter_pool;
+	Random m_random;
+	Animator m_animator;
+};
@@ -0,0 +1,29 @@
+#include "EntityHandle.hpp"
+
+//Generation 0 is never handed out, a default constructed handle never resolves
+EntityHandle::EntityHandle()
+	: m_index(0)
+	, m_generation(0)
+{
+}
+
+EntityHandle::EntityHandle(std::uint32_t index, std::uint32_t generation)
+	: m_index(index)
+	, m_generation(generation)
+{
+}
+
+bool EntityHandle::IsNull() const
+{
+	return m_generation == 0;
+}
+
+bool operator==(const EntityHandle& lhs, const EntityHandle& rhs)
+{
+	return lhs.m_index == rhs.m_index && lhs.m_generation == rhs.m_generation;
+}
+
+bool operator!=(const EntityHandle& lhs, const EntityHandle& rhs)
+{
+	return !(lhs == rhs);
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+
+//Weak reference to an Entity registered with an EntityStore
+//The generation changes every time a handle slot is reused, so a handle to a removed entity
+//resolves to nullptr instead of pointing at whatever took its place
+struct EntityHandle
+{
+	EntityHandle();
+	EntityHandle(std::uint32_t index, std::uint32_t generation);
+	bool IsNull() const;
+
+	std::uint32_t m_index;
+	std::uint32_t m_generation;
+};
+
+bool operator==(const EntityHandle& lhs, const EntityHandle& rhs);
+bool operator!=(const EntityHandle& lhs, const EntityHandle& rhs);
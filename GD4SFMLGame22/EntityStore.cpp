@@ -0,0 +1,471 @@
+#include "EntityStore.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Entity.hpp"
+#include "JobSystem.hpp"
+#include "SimMath.hpp"
+
+//The kernels treat the vector arrays as flat float arrays
+static_assert(sizeof(sf::Vector2f) == 2 * sizeof(float), "sf::Vector2f must be two packed floats");
+
+namespace
+{
+	//Entities per job, small enough to spread a few hundred entities over the workers
+	const std::size_t kIntegrateGrainSize = 128;
+	//A few times the size of an aircraft, so most cells hold only a handful of entities
+	const float kBroadphaseCellSize = 128.f;
+}
+
+EntityStore::EntityStore()
+	: m_positions()
+	, m_velocities()
+	, m_mobility()
+	, m_displacements()
+	, m_local_bounds()
+	, m_min_x()
+	, m_min_y()
+	, m_max_x()
+	, m_max_y()
+	, m_flags()
+	, m_owners()
+	, m_grid(kBroadphaseCellSize)
+	, m_index_pairs()
+	, m_handle_slots()
+	, m_free_handles()
+	, m_removals()
+	, m_wreck_parents()
+{
+}
+
+EntityStore::Index EntityStore::Add(Entity& owner, sf::Vector2f position, sf::Vector2f velocity, unsigned int flags)
+{
+	m_positions.emplace_back(position);
+	m_velocities.emplace_back(velocity);
+	m_mobility.emplace_back(1.f, 1.f);
+	m_displacements.emplace_back();
+	m_local_bounds.emplace_back();
+	m_min_x.emplace_back(position.x);
+	m_min_y.emplace_back(position.y);
+	m_max_x.emplace_back(position.x);
+	m_max_y.emplace_back(position.y);
+	m_flags.emplace_back(kNone);
+	m_owners.emplace_back(&owner);
+	owner.m_handle = AcquireHandle(owner);
+
+	//The owner has not been placed yet, so its bounds are measured on the next Integrate
+	Index index = m_owners.size() - 1;
+	SetFlag(index, static_cast<Flags>(flags | kBoundsDirty), true);
+	return index;
+}
+
+void EntityStore::Remove(Index index)
+{
+	assert(index < m_owners.size());
+	ReleaseHandle(m_owners[index]->m_handle);
+	m_owners[index]->m_handle = EntityHandle();
+
+	Index last = m_owners.size() - 1;
+	if (index != last)
+	{
+		m_positions[index] = m_positions[last];
+		m_velocities[index] = m_velocities[last];
+		m_mobility[index] = m_mobility[last];
+		m_displacements[index] = m_displacements[last];
+		m_local_bounds[index] = m_local_bounds[last];
+		m_min_x[index] = m_min_x[last];
+		m_min_y[index] = m_min_y[last];
+		m_max_x[index] = m_max_x[last];
+		m_max_y[index] = m_max_y[last];
+		m_flags[index] = m_flags[last];
+		m_owners[index] = m_owners[last];
+		m_owners[index]->m_store_index = index;
+	}
+	m_positions.pop_back();
+	m_velocities.pop_back();
+	m_mobility.pop_back();
+	m_displacements.pop_back();
+	m_local_bounds.pop_back();
+	m_min_x.pop_back();
+	m_min_y.pop_back();
+	m_max_x.pop_back();
+	m_max_y.pop_back();
+	m_flags.pop_back();
+	m_owners.pop_back();
+}
+
+std::size_t EntityStore::GetSize() const
+{
+	return m_owners.size();
+}
+
+//nullptr once the entity has left the store, even if its handle slot has been reused since
+Entity* EntityStore::GetEntity(EntityHandle handle) const
+{
+	if (handle.m_index >= m_handle_slots.size() || m_handle_slots[handle.m_index].m_generation != handle.m_generation)
+	{
+		return nullptr;
+	}
+	return m_handle_slots[handle.m_index].m_entity;
+}
+
+Entity* EntityStore::GetOwner(Index index) const
+{
+	return m_owners[index];
+}
+
+//Swaps entity into slot index, restoring a World puts its entities back in the slots they were saved from
+//so collision pairs come out in the same order as they did the first time
+void EntityStore::PlaceAt(Index index, Entity& entity)
+{
+	assert(entity.m_store == this && index < m_owners.size());
+	Index other = entity.m_store_index;
+	if (other == index)
+	{
+		return;
+	}
+
+	std::swap(m_positions[index], m_positions[other]);
+	std::swap(m_velocities[index], m_velocities[other]);
+	std::swap(m_mobility[index], m_mobility[other]);
+	std::swap(m_displacements[index], m_displacements[other]);
+	std::swap(m_local_bounds[index], m_local_bounds[other]);
+	std::swap(m_min_x[index], m_min_x[other]);
+	std::swap(m_min_y[index], m_min_y[other]);
+	std::swap(m_max_x[index], m_max_x[other]);
+	std::swap(m_max_y[index], m_max_y[other]);
+	std::swap(m_flags[index], m_flags[other]);
+	std::swap(m_owners[index], m_owners[other]);
+	m_owners[index]->m_store_index = index;
+	m_owners[other]->m_store_index = other;
+}
+
+sf::Vector2f EntityStore::GetPosition(Index index) const
+{
+	return m_positions[index];
+}
+
+//travelled counts the change as movement made this step, so it is swept and interpolated like integrated motion
+//Teleports and spawns are not, or a new projectile would hit everything between the origin and its launcher
+void EntityStore::SetPosition(Index index, sf::Vector2f position, bool travelled)
+{
+	if (travelled)
+	{
+		m_displacements[index] += position - m_positions[index];
+	}
+	else
+	{
+		m_displacements[index] = sf::Vector2f();
+	}
+	m_positions[index] = position;
+	UpdateBox(index);
+}
+
+sf::Vector2f EntityStore::GetVelocity(Index index) const
+{
+	return m_velocities[index];
+}
+
+void EntityStore::SetVelocity(Index index, sf::Vector2f velocity)
+{
+	m_velocities[index] = velocity;
+}
+
+sf::FloatRect EntityStore::GetBounds(Index index) const
+{
+	return sf::FloatRect(m_min_x[index], m_min_y[index], m_max_x[index] - m_min_x[index], m_max_y[index] - m_min_y[index]);
+}
+
+void EntityStore::MarkBoundsDirty(Index index)
+{
+	m_flags[index] |= kBoundsDirty;
+}
+
+void EntityStore::SetFlag(Index index, Flags flag, bool enabled)
+{
+	if (enabled)
+	{
+		m_flags[index] |= flag;
+	}
+	else
+	{
+		m_flags[index] &= ~flag;
+	}
+	float mobility = (m_flags[index] & kFrozen) ? 0.f : 1.f;
+	m_mobility[index] = sf::Vector2f(mobility, mobility);
+}
+
+bool EntityStore::HasFlag(Index index, Flags flag) const
+{
+	return (m_flags[index] & flag) != 0;
+}
+
+//Every range only touches its own slots and its own entities' transforms, so the ranges run in parallel
+void EntityStore::Integrate(float dt, JobSystem& jobs)
+{
+	const std::size_t count = m_owners.size();
+	jobs.ParallelFor(count, kIntegrateGrainSize, [this, dt](std::size_t begin, std::size_t end)
+	{
+		//Apply movement
+		std::copy(m_positions.begin() + begin, m_positions.begin() + end, m_displacements.begin() + begin);
+		SimMath::Integrate(&m_positions[begin].x, &m_velocities[begin].x, &m_mobility[begin].x, (end - begin) * 2, dt);
+
+		//Hand the new positions back to the scene nodes for drawing and child transforms
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			m_displacements[i] = m_positions[i] - m_displacements[i];
+			m_owners[i]->SyncPosition(m_positions[i]);
+		}
+	});
+
+	//Measuring walks up through parent transforms that are shared between entities, so it stays on this thread
+	RefreshBounds();
+
+	jobs.ParallelFor(count, kIntegrateGrainSize, [this](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			UpdateBox(i);
+		}
+	});
+}
+
+//Places the scene nodes part way along their last move for drawing, 1 puts them back where the simulation has them
+void EntityStore::Interpolate(float alpha)
+{
+	const float remaining = 1.f - alpha;
+	const std::size_t count = m_owners.size();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		m_owners[i]->SyncPosition(m_positions[i] - m_displacements[i] * remaining);
+	}
+}
+
+//Measure entities that turned, scaled or were spawned since the last call
+void EntityStore::RefreshBounds()
+{
+	const std::size_t count = m_owners.size();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (m_flags[i] & kBoundsDirty)
+		{
+			sf::FloatRect bounds = m_owners[i]->GetBoundingRect();
+			bounds.left -= m_positions[i].x;
+			bounds.top -= m_positions[i].y;
+			m_local_bounds[i] = bounds;
+			m_flags[i] &= ~kBoundsDirty;
+			UpdateBox(i);
+		}
+	}
+}
+
+void EntityStore::CullOutside(const sf::FloatRect& view_bounds)
+{
+	const float left = view_bounds.left;
+	const float top = view_bounds.top;
+	const float right = view_bounds.left + view_bounds.width;
+	const float bottom = view_bounds.top + view_bounds.height;
+
+	const std::size_t count = m_owners.size();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		//Entities that have not been measured yet were only just spawned, leave them until the next frame
+		if ((m_flags[i] & (kCullOutsideView | kBoundsDirty)) != kCullOutsideView)
+		{
+			continue;
+		}
+		if (m_max_x[i] <= left || m_min_x[i] >= right || m_max_y[i] <= top || m_min_y[i] >= bottom)
+		{
+			//Remove only changes hitpoints and flags, the slots stay where they are
+			m_owners[i]->Remove();
+		}
+	}
+}
+
+//Every pair of live entities whose boxes overlap, each pair is reported once, ordered by slot index
+//Boxes of kContinuous entities cover their whole last move, so those candidates get an exact swept test
+//Bounds must be current, call RefreshBounds first if entities were spawned since the last Integrate
+void EntityStore::FindCollisionPairs(SceneNode::PairList& pairs, JobSystem& jobs)
+{
+	m_grid.Clear();
+	const std::size_t count = m_owners.size();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (!(m_flags[i] & kFrozen))
+		{
+			m_grid.Insert(static_cast<std::uint32_t>(i), m_min_x[i], m_min_y[i], m_max_x[i], m_max_y[i]);
+		}
+	}
+	m_grid.Build();
+
+	m_grid.FindPairs(jobs, [this](std::uint32_t first, std::uint32_t second)
+	{
+		return !((m_flags[first] | m_flags[second]) & kContinuous) || SweptOverlap(first, second);
+	}, m_index_pairs);
+
+	for (const BroadphaseGrid::IndexPair& pair : m_index_pairs)
+	{
+		pairs.emplace_back(m_owners[pair.first], m_owners[pair.second]);
+	}
+}
+
+AabbArrays EntityStore::GetBoxes() const
+{
+	AabbArrays boxes = { m_min_x.data(), m_min_y.data(), m_max_x.data(), m_max_y.data() };
+	return boxes;
+}
+
+void EntityStore::UpdateBox(Index index)
+{
+	sf::FloatRect bounds = GetEndBounds(index);
+	m_min_x[index] = bounds.left;
+	m_min_y[index] = bounds.top;
+	m_max_x[index] = bounds.left + bounds.width;
+	m_max_y[index] = bounds.top + bounds.height;
+
+	//Grow the box to also cover where the entity started, the broadphase then finds everything it passed through
+	if (m_flags[index] & kContinuous)
+	{
+		sf::Vector2f displacement = m_displacements[index];
+		m_min_x[index] -= std::max(displacement.x, 0.f);
+		m_max_x[index] -= std::min(displacement.x, 0.f);
+		m_min_y[index] -= std::max(displacement.y, 0.f);
+		m_max_y[index] -= std::min(displacement.y, 0.f);
+	}
+}
+
+//Box at the current position, without the sweep
+sf::FloatRect EntityStore::GetEndBounds(Index index) const
+{
+	const sf::FloatRect& local = m_local_bounds[index];
+	return sf::FloatRect(m_positions[index].x + local.left, m_positions[index].y + local.top, local.width, local.height);
+}
+
+//Moves the first box along its motion relative to the second one and reports whether they overlap at any time during the step
+//Like sf::FloatRect::intersects, boxes that only touch do not overlap
+bool EntityStore::SweptOverlap(Index first, Index second) const
+{
+	sf::FloatRect moving = GetEndBounds(first);
+	sf::FloatRect target = GetEndBounds(second);
+	sf::Vector2f motion = m_displacements[first] - m_displacements[second];
+
+	const float moving_min[2] = { moving.left - motion.x, moving.top - motion.y };
+	const float moving_max[2] = { moving_min[0] + moving.width, moving_min[1] + moving.height };
+	const float target_min[2] = { target.left, target.top };
+	const float target_max[2] = { target.left + target.width, target.top + target.height };
+	const float delta[2] = { motion.x, motion.y };
+
+	float enter = 0.f;
+	float exit = 1.f;
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		if (delta[axis] == 0.f)
+		{
+			if (!(moving_min[axis] < target_max[axis] && target_min[axis] < moving_max[axis]))
+			{
+				return false;
+			}
+			continue;
+		}
+
+		float axis_enter = (target_min[axis] - moving_max[axis]) / delta[axis];
+		float axis_exit = (target_max[axis] - moving_min[axis]) / delta[axis];
+		if (axis_enter > axis_exit)
+		{
+			std::swap(axis_enter, axis_exit);
+		}
+		enter = std::max(enter, axis_enter);
+		exit = std::min(exit, axis_exit);
+		if (enter >= exit)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void EntityStore::QueueRemoval(Index index)
+{
+	if (!(m_flags[index] & kRemovalQueued))
+	{
+		m_flags[index] |= kRemovalQueued;
+		m_removals.emplace_back(m_owners[index]->m_handle);
+	}
+}
+
+//Disposes of every queued entity that is now marked for removal
+//Only the parents of those entities have their child lists compacted, the rest of the scene graph is not visited
+void EntityStore::RemoveWrecks()
+{
+	m_wreck_parents.clear();
+
+	auto kept = m_removals.begin();
+	for (EntityHandle handle : m_removals)
+	{
+		Entity* entity = GetEntity(handle);
+		if (!entity)
+		{
+			continue;
+		}
+
+		Index index = entity->m_store_index;
+		if (entity->IsMarkedForRemoval())
+		{
+			m_flags[index] &= ~kRemovalQueued;
+			if (SceneNode* parent = entity->GetParent())
+			{
+				m_wreck_parents.emplace_back(parent);
+			}
+		}
+		else if (entity->IsDestroyed())
+		{
+			//Still finishing off, e.g. an animation that has to play out first
+			*kept++ = handle;
+		}
+		else
+		{
+			//Repaired in the meantime
+			m_flags[index] &= ~kRemovalQueued;
+		}
+	}
+	m_removals.erase(kept, m_removals.end());
+
+	std::sort(m_wreck_parents.begin(), m_wreck_parents.end());
+	m_wreck_parents.erase(std::unique(m_wreck_parents.begin(), m_wreck_parents.end()), m_wreck_parents.end());
+	for (SceneNode* parent : m_wreck_parents)
+	{
+		parent->RemoveMarkedChildren();
+	}
+}
+
+EntityHandle EntityStore::AcquireHandle(Entity& owner)
+{
+	std::uint32_t index;
+	if (m_free_handles.empty())
+	{
+		index = static_cast<std::uint32_t>(m_handle_slots.size());
+		HandleSlot slot = { nullptr, 1 };
+		m_handle_slots.emplace_back(slot);
+	}
+	else
+	{
+		index = m_free_handles.back();
+		m_free_handles.pop_back();
+	}
+	m_handle_slots[index].m_entity = &owner;
+	return EntityHandle(index, m_handle_slots[index].m_generation);
+}
+
+void EntityStore::ReleaseHandle(EntityHandle handle)
+{
+	HandleSlot& slot = m_handle_slots[handle.m_index];
+	assert(slot.m_generation == handle.m_generation);
+	slot.m_entity = nullptr;
+	//Skip 0 on wrap around, it is reserved for null handles
+	if (++slot.m_generation == 0)
+	{
+		slot.m_generation = 1;
+	}
+	m_free_handles.emplace_back(handle.m_index);
+}
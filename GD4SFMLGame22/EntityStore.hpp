@@ -0,0 +1,106 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BroadphaseGrid.hpp"
+#include "EntityHandle.hpp"
+#include "SceneNode.hpp"
+#include "SimdKernels.hpp"
+
+class Entity;
+class JobSystem;
+
+//Structure of arrays storage for the moving entities of a World
+//Position, velocity and bounding box of every registered Entity live in contiguous arrays,
+//so integrating movement and the view bounds test are straight loops rather than a walk over the scene graph
+//Slots are kept densely packed, removing an entity moves the last slot into the hole
+//Code outside the store holds on to entities through generational EntityHandles, which stay safe to resolve after removal
+class EntityStore : private sf::NonCopyable
+{
+public:
+	typedef std::size_t Index;
+
+	enum Flags
+	{
+		kNone = 0,
+		kFrozen = 1 << 0,
+		kCullOutsideView = 1 << 1,
+		kBoundsDirty = 1 << 2,
+		kRemovalQueued = 1 << 3,
+		//Collides along the whole path it moved in the last Integrate, not just where it ended up
+		kContinuous = 1 << 4,
+	};
+
+public:
+	EntityStore();
+
+	Index Add(Entity& owner, sf::Vector2f position, sf::Vector2f velocity, unsigned int flags);
+	void Remove(Index index);
+	std::size_t GetSize() const;
+	Entity* GetEntity(EntityHandle handle) const;
+	Entity* GetOwner(Index index) const;
+	void PlaceAt(Index index, Entity& entity);
+
+	sf::Vector2f GetPosition(Index index) const;
+	void SetPosition(Index index, sf::Vector2f position, bool travelled = false);
+	sf::Vector2f GetVelocity(Index index) const;
+	void SetVelocity(Index index, sf::Vector2f velocity);
+	sf::FloatRect GetBounds(Index index) const;
+	void MarkBoundsDirty(Index index);
+
+	void SetFlag(Index index, Flags flag, bool enabled);
+	bool HasFlag(Index index, Flags flag) const;
+
+	void Integrate(float dt, JobSystem& jobs);
+	void Interpolate(float alpha);
+	void RefreshBounds();
+	void CullOutside(const sf::FloatRect& view_bounds);
+	void FindCollisionPairs(SceneNode::PairList& pairs, JobSystem& jobs);
+	AabbArrays GetBoxes() const;
+
+	void QueueRemoval(Index index);
+	void RemoveWrecks();
+
+private:
+	struct HandleSlot
+	{
+		Entity* m_entity;
+		std::uint32_t m_generation;
+	};
+
+private:
+	void UpdateBox(Index index);
+	sf::FloatRect GetEndBounds(Index index) const;
+	bool SweptOverlap(Index first, Index second) const;
+	EntityHandle AcquireHandle(Entity& owner);
+	void ReleaseHandle(EntityHandle handle);
+
+private:
+	std::vector<sf::Vector2f> m_positions;
+	std::vector<sf::Vector2f> m_velocities;
+	//1 for entities that move and 0 for frozen ones, lets Integrate run as one branch free kernel
+	std::vector<sf::Vector2f> m_mobility;
+	//How far each entity moved in the last Integrate, zeroed when it is placed by hand
+	std::vector<sf::Vector2f> m_displacements;
+	//Bounding box relative to the position, only re-measured when an entity turns, scales or changes sprite
+	std::vector<sf::FloatRect> m_local_bounds;
+	std::vector<float> m_min_x;
+	std::vector<float> m_min_y;
+	std::vector<float> m_max_x;
+	std::vector<float> m_max_y;
+	std::vector<unsigned int> m_flags;
+	std::vector<Entity*> m_owners;
+	BroadphaseGrid m_grid;
+	std::vector<BroadphaseGrid::IndexPair> m_index_pairs;
+
+	std::vector<HandleSlot> m_handle_slots;
+	std::vector<std::uint32_t> m_free_handles;
+	//Destroyed entities waiting for IsMarkedForRemoval, and the parents that have wrecks to sweep this frame
+	std::vector<EntityHandle> m_removals;
+	std::vector<SceneNode*> m_wreck_parents;
+};
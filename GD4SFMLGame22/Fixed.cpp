@@ -0,0 +1,83 @@
+#include "Fixed.hpp"
+
+#include <cstddef>
+
+namespace
+{
+	//Digit by digit square root, floor(sqrt(value)) using only shifts, adds and compares
+	std::uint64_t IntegerSqrt(std::uint64_t value)
+	{
+		std::uint64_t result = 0;
+		std::uint64_t bit = 1ull << 62;
+		while (bit > value)
+		{
+			bit >>= 2;
+		}
+		while (bit != 0)
+		{
+			if (value >= result + bit)
+			{
+				value -= result + bit;
+				result = (result >> 1) + bit;
+			}
+			else
+			{
+				result >>= 1;
+			}
+			bit >>= 2;
+		}
+		return result;
+	}
+
+	//Odd polynomial for atan on [0, 1] from Abramowitz and Stegun 4.4.47, error below 1e-5,
+	//which is as fine as 16 fraction bits can tell apart. Coefficients are raw values so no float is involved
+	Fixed AtanUnit(Fixed z)
+	{
+		static const std::int64_t kCoefficients[] = { 1365, -5579, 11806, -21647, 65527 };
+
+		const Fixed z_squared = z * z;
+		Fixed sum = Fixed::FromRaw(kCoefficients[0]);
+		for (std::size_t i = 1; i < sizeof(kCoefficients) / sizeof(kCoefficients[0]); ++i)
+		{
+			sum = sum * z_squared + Fixed::FromRaw(kCoefficients[i]);
+		}
+		return sum * z;
+	}
+}
+
+Fixed Fixed::Sqrt(Fixed value)
+{
+	assert(value.m_raw >= 0);
+	//sqrt(raw * 2^16) is the raw result, shifting up first keeps all 16 fraction bits while it fits
+	const std::uint64_t raw = static_cast<std::uint64_t>(value.m_raw);
+	if (raw < (1ull << (63 - kFractionBits)))
+	{
+		return FromRaw(static_cast<std::int64_t>(IntegerSqrt(raw << kFractionBits)));
+	}
+	return FromRaw(static_cast<std::int64_t>(IntegerSqrt(raw) << (kFractionBits / 2)));
+}
+
+Fixed Fixed::Atan2(Fixed y, Fixed x)
+{
+	if (x.m_raw == 0 && y.m_raw == 0)
+	{
+		return Fixed();
+	}
+
+	//Fold into the first octant, where the ratio is at most 1, then unfold
+	const Fixed abs_x = Abs(x);
+	const Fixed abs_y = Abs(y);
+	const Fixed half_pi = FromRaw(Pi().m_raw / 2);
+	Fixed angle = abs_y <= abs_x ? AtanUnit(abs_y / abs_x) : half_pi - AtanUnit(abs_x / abs_y);
+	if (x.m_raw < 0)
+	{
+		angle = Pi() - angle;
+	}
+	return y.m_raw < 0 ? -angle : angle;
+}
+
+Fixed Fixed::Pi()
+{
+	//Round(pi * 2^16)
+	return FromRaw(205887);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+
+//Signed 48.16 fixed point number for simulation maths that has to come out bit for bit the same on every compiler and CPU
+//Everything is integer arithmetic, including Sqrt and Atan2, so there is no rounding mode, FMA contraction or
+//library implementation for two machines to disagree on. Products and quotients stay exact up to about 2^31
+//Converting to and from float is exact or correctly rounded by IEEE, so results can be kept in float storage
+class Fixed
+{
+public:
+	static const int kFractionBits = 16;
+
+public:
+	Fixed();
+	explicit Fixed(float value);
+	explicit Fixed(int value);
+	static Fixed FromRaw(std::int64_t raw);
+
+	float ToFloat() const;
+	std::int64_t GetRaw() const;
+
+	Fixed operator-() const;
+	Fixed& operator+=(Fixed other);
+	Fixed& operator-=(Fixed other);
+	Fixed& operator*=(Fixed other);
+	Fixed& operator/=(Fixed other);
+
+	static Fixed Abs(Fixed value);
+	//Rounded down to the nearest 2^-16
+	static Fixed Sqrt(Fixed value);
+	//Angle of (x, y) in radians in [-pi, pi], within 1e-4 of the exact value
+	static Fixed Atan2(Fixed y, Fixed x);
+	static Fixed Pi();
+
+private:
+	std::int64_t m_raw;
+};
+
+Fixed operator+(Fixed first, Fixed second);
+Fixed operator-(Fixed first, Fixed second);
+Fixed operator*(Fixed first, Fixed second);
+Fixed operator/(Fixed first, Fixed second);
+bool operator==(Fixed first, Fixed second);
+bool operator!=(Fixed first, Fixed second);
+bool operator<(Fixed first, Fixed second);
+bool operator>(Fixed first, Fixed second);
+bool operator<=(Fixed first, Fixed second);
+bool operator>=(Fixed first, Fixed second);
+
+#include "Fixed.inl"
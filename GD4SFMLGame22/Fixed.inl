@@ -0,0 +1,122 @@
+#include <cassert>
+#include <cmath>
+
+inline Fixed::Fixed()
+	: m_raw(0)
+{
+}
+
+//Scaling by a power of two is exact, so the only rounding is the correctly rounded llround
+inline Fixed::Fixed(float value)
+	: m_raw(std::llround(static_cast<double>(value) * (1 << kFractionBits)))
+{
+}
+
+inline Fixed::Fixed(int value)
+	: m_raw(static_cast<std::int64_t>(value) * (1 << kFractionBits))
+{
+}
+
+inline Fixed Fixed::FromRaw(std::int64_t raw)
+{
+	Fixed value;
+	value.m_raw = raw;
+	return value;
+}
+
+inline float Fixed::ToFloat() const
+{
+	return static_cast<float>(m_raw) * (1.f / (1 << kFractionBits));
+}
+
+inline std::int64_t Fixed::GetRaw() const
+{
+	return m_raw;
+}
+
+inline Fixed Fixed::operator-() const
+{
+	return FromRaw(-m_raw);
+}
+
+inline Fixed& Fixed::operator+=(Fixed other)
+{
+	m_raw += other.m_raw;
+	return *this;
+}
+
+inline Fixed& Fixed::operator-=(Fixed other)
+{
+	m_raw -= other.m_raw;
+	return *this;
+}
+
+//Rounds to nearest, ties towards +infinity. Right shifts of negative values are arithmetic on every supported compiler
+inline Fixed& Fixed::operator*=(Fixed other)
+{
+	m_raw = (m_raw * other.m_raw + (1 << (kFractionBits - 1))) >> kFractionBits;
+	return *this;
+}
+
+//Truncates towards zero, as integer division does
+inline Fixed& Fixed::operator/=(Fixed other)
+{
+	assert(other.m_raw != 0);
+	m_raw = (m_raw * (1 << kFractionBits)) / other.m_raw;
+	return *this;
+}
+
+inline Fixed Fixed::Abs(Fixed value)
+{
+	return value.m_raw < 0 ? -value : value;
+}
+
+inline Fixed operator+(Fixed first, Fixed second)
+{
+	return first += second;
+}
+
+inline Fixed operator-(Fixed first, Fixed second)
+{
+	return first -= second;
+}
+
+inline Fixed operator*(Fixed first, Fixed second)
+{
+	return first *= second;
+}
+
+inline Fixed operator/(Fixed first, Fixed second)
+{
+	return first /= second;
+}
+
+inline bool operator==(Fixed first, Fixed second)
+{
+	return first.GetRaw() == second.GetRaw();
+}
+
+inline bool operator!=(Fixed first, Fixed second)
+{
+	return first.GetRaw() != second.GetRaw();
+}
+
+inline bool operator<(Fixed first, Fixed second)
+{
+	return first.GetRaw() < second.GetRaw();
+}
+
+inline bool operator>(Fixed first, Fixed second)
+{
+	return first.GetRaw() > second.GetRaw();
+}
+
+inline bool operator<=(Fixed first, Fixed second)
+{
+	return first.GetRaw() <= second.GetRaw();
+}
+
+inline bool operator>=(Fixed first, Fixed second)
+{
+	return first.GetRaw() >= second.GetRaw();
+}
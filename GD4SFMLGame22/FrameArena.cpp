@@ -0,0 +1,71 @@
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+const std::size_t FrameArena::kDefaultBlockSize = 64 * 1024;
+
+FrameArena::FrameArena(std::size_t block_size)
+	: m_blocks()
+	, m_block_size(block_size)
+	, m_current_block(0)
+	, m_offset(0)
+	, m_bytes_allocated(0)
+{
+	AddBlock(m_block_size);
+}
+
+void* FrameArena::Allocate(std::size_t size, std::size_t alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+	while (true)
+	{
+		Block& block = m_blocks[m_current_block];
+		std::size_t aligned_offset = (m_offset + alignment - 1) & ~(alignment - 1);
+		if (aligned_offset + size <= block.m_size)
+		{
+			m_offset = aligned_offset + size;
+			m_bytes_allocated += size;
+			return block.m_memory.get() + aligned_offset;
+		}
+
+		//Current block is full, move on to the next one we already own or grow the arena
+		++m_current_block;
+		m_offset = 0;
+		if (m_current_block == m_blocks.size())
+		{
+			AddBlock(size + alignment);
+		}
+	}
+}
+
+void FrameArena::Reset()
+{
+	m_current_block = 0;
+	m_offset = 0;
+	m_bytes_allocated = 0;
+}
+
+std::size_t FrameArena::GetBytesAllocated() const
+{
+	return m_bytes_allocated;
+}
+
+std::size_t FrameArena::GetCapacity() const
+{
+	std::size_t capacity = 0;
+	for (const Block& block : m_blocks)
+	{
+		capacity += block.m_size;
+	}
+	return capacity;
+}
+
+void FrameArena::AddBlock(std::size_t minimum_size)
+{
+	Block block;
+	block.m_size = std::max(m_block_size, minimum_size);
+	block.m_memory.reset(new char[block.m_size]);
+	m_blocks.emplace_back(std::move(block));
+}
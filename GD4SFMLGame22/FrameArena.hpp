@@ -0,0 +1,70 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+//Monotonic bump allocator for data that only lives for one World::Update
+//Memory is handed out from large blocks and is only given back all at once in Reset()
+//The blocks are kept between frames, so once warmed up a frame does not touch the global heap
+class FrameArena : private sf::NonCopyable
+{
+public:
+	explicit FrameArena(std::size_t block_size = kDefaultBlockSize);
+
+	void* Allocate(std::size_t size, std::size_t alignment);
+	void Reset();
+
+	std::size_t GetBytesAllocated() const;
+	std::size_t GetCapacity() const;
+
+private:
+	struct Block
+	{
+		std::unique_ptr<char[]> m_memory;
+		std::size_t m_size;
+	};
+
+private:
+	void AddBlock(std::size_t minimum_size);
+
+private:
+	static const std::size_t kDefaultBlockSize;
+
+	std::vector<Block> m_blocks;
+	std::size_t m_block_size;
+	std::size_t m_current_block;
+	std::size_t m_offset;
+	std::size_t m_bytes_allocated;
+};
+
+//Standard library allocator that takes its memory from a FrameArena
+//deallocate does nothing, the memory is reclaimed when the arena is reset
+//Containers using it must be destroyed or emptied of storage before FrameArena::Reset
+template <typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+
+public:
+	explicit FrameAllocator(FrameArena& arena);
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other);
+
+	T* allocate(std::size_t count);
+	void deallocate(T* pointer, std::size_t count);
+
+	FrameArena& GetArena() const;
+
+private:
+	FrameArena* m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& lhs, const FrameAllocator<U>& rhs);
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& lhs, const FrameAllocator<U>& rhs);
+
+#include "FrameArena.inl"
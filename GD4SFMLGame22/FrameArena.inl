@@ -0,0 +1,42 @@
+template <typename T>
+FrameAllocator<T>::FrameAllocator(FrameArena& arena)
+	: m_arena(&arena)
+{
+}
+
+template <typename T>
+template <typename U>
+FrameAllocator<T>::FrameAllocator(const FrameAllocator<U>& other)
+	: m_arena(&other.GetArena())
+{
+}
+
+template <typename T>
+T* FrameAllocator<T>::allocate(std::size_t count)
+{
+	return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+void FrameAllocator<T>::deallocate(T*, std::size_t)
+{
+	//Nothing to do, the arena releases everything in one go
+}
+
+template <typename T>
+FrameArena& FrameAllocator<T>::GetArena() const
+{
+	return *m_arena;
+}
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& lhs, const FrameAllocator<U>& rhs)
+{
+	return &lhs.GetArena() == &rhs.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& lhs, const FrameAllocator<U>& rhs)
+{
+	return !(lhs == rhs);
+}
@@ -0,0 +1,19 @@
+#include "FrameSample.hpp"
+
+RenderCounters::RenderCounters()
+	: m_draw_calls(0)
+	, m_vertices(0)
+	, m_texture_binds(0)
+	, m_state_changes(0)
+{
+}
+
+FrameSample::FrameSample()
+	: m_update(sf::Time::Zero)
+	, m_record(sf::Time::Zero)
+	, m_replay(sf::Time::Zero)
+	, m_display(sf::Time::Zero)
+	, m_counters()
+	, m_dropped_frames(0)
+{
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <SFML/System/Time.hpp>
+
+#include <cstddef>
+
+//What replaying one frame asked of the target, counted by RenderSnapshot::Replay
+struct RenderCounters
+{
+	RenderCounters();
+
+	std::size_t m_draw_calls;
+	std::size_t m_vertices;
+	std::size_t m_texture_binds;
+	//Views, blend modes and transforms that differ from the previous draw's
+	std::size_t m_state_changes;
+};
+
+//CPU time spent on one presented frame in each phase, with the counters of its replay
+//The simulation thread fills in the update and record times before publishing the frame,
+//the render thread adds the rest once the frame is on screen
+struct FrameSample
+{
+	FrameSample();
+
+	//All the updates run since the previous frame was recorded. Both times include those of the frames
+	//dropped since the previous one was presented, so no work goes uncounted
+	sf::Time m_update;
+	sf::Time m_record;
+	sf::Time m_replay;
+	sf::Time m_display;
+	RenderCounters m_counters;
+	//Frames published but replaced by a newer one before the render thread picked them up
+	std::size_t m_dropped_frames;
+};
@@ -4,6 +4,7 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 
 #include "Player.hpp"
+#include "RenderSnapshot.hpp"
 #include "ResourceHolder.hpp"
 #include "Utility.hpp"
 
@@ -23,18 +24,17 @@ GameOverState::GameOverState(StateStack& stack, Context context, const std::stri
 	m_game_over_text.setPosition(0.5f * windowSize.x, 0.4f * windowSize.y);
 }
 
-void GameOverState::Draw()
+void GameOverState::Draw(RenderSnapshot& snapshot)
 {
-	sf::RenderWindow& window = *GetContext().window;
-	window.setView(window.getDefaultView());
+	snapshot.SetView(snapshot.GetDefaultView());
 
 	// Create dark, semitransparent background
 	sf::RectangleShape backgroundShape;
 	backgroundShape.setFillColor(sf::Color(0, 0, 0, 150));
-	backgroundShape.setSize(window.getView().getSize());
+	backgroundShape.setSize(snapshot.GetDefaultView().getSize());
 
-	window.draw(backgroundShape);
-	window.draw(m_game_over_text);
+	snapshot.Draw(backgroundShape);
+	snapshot.Draw(m_game_over_text);
 }
 
 bool GameOverState::Update(sf::Time dt)
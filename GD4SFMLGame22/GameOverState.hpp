@@ -8,7 +8,7 @@ class GameOverState : public State
 public:
 	GameOverState(StateStack& stack, Context context, const std::string& text);
 
-	virtual void		Draw();
+	virtual void		Draw(RenderSnapshot& snapshot);
 	virtual bool		Update(sf::Time dt);
 	virtual bool		HandleEvent(const sf::Event& event);
 
@@ -6,7 +6,6 @@
 
 #include "Aircraft.hpp"
 #include "PickupType.hpp"
-#include "Utility.hpp"
 
 #include <iostream>
 
@@ -18,8 +17,9 @@ GameServer::RemotePeer::RemotePeer():m_ready(false), m_timed_out(false)
 	m_socket.setBlocking(false);
 }
 
-GameServer::GameServer(sf::Vector2f battlefield_size)
-	: m_thread(&GameServer::ExecutionThread, this)
+GameServer::GameServer(sf::Vector2f battlefield_size, NetworkMode network_mode)
+	: m_network_mode(network_mode)
+	, m_thread(&GameServer::ExecutionThread, this)
 	, m_listening_state(false)
 	, m_client_timeout(sf::seconds(1.f))
 	, m_max_connected_players(15)
@@ -33,6 +33,7 @@ GameServer::GameServer(sf::Vector2f battlefield_size)
 	, m_waiting_thread_end(false)
 	, m_last_spawn_time(sf::Time::Zero)
 	, m_time_for_next_spawn(sf::seconds(5.f))
+	, m_random(Random::ForThisThread().Split())
 {
 	m_listener_socket.setBlocking(false);
 	m_peers[0].reset(new RemotePeer());
@@ -173,14 +174,20 @@ void GameServer::ExecutionThread()
 			tick_time -= tick_rate;
 		}
 
-		//sleep
-		sf::sleep(sf::milliseconds(100));
+		//sleep, rollback peers get each tick's input relayed as it comes in rather than in bursts
+		sf::sleep(m_network_mode == NetworkMode::kRollback ? sf::milliseconds(1) : sf::milliseconds(100));
 
 	}
 }
 
 void GameServer::Tick()
 {
+	//Rollback peers simulate everything from each other's inputs, there is no state to correct or spawns to hand out
+	if (m_network_mode == NetworkMode::kRollback)
+	{
+		return;
+	}
+
 	UpdateClientState();
 
 	//Check if the game is over = all planes position.y < offset
@@ -220,8 +227,8 @@ void GameServer::Tick()
 		//Not going to spawn enemies near the end
 		if(m_battlefield_rect.top > 600.f)
 		{
-			std::size_t enemy_count = 1 + Utility::RandomInt(2);
-			float spawn_centre = static_cast<float>(Utility::RandomInt(500) - 250);
+			std::size_t enemy_count = 1 + m_random.NextInt(2);
+			float spawn_centre = static_cast<float>(m_random.NextInt(500) - 250);
 
 			//If there is only one enemy it is at the spawn_centre
 			float plane_distance = 0.f;
@@ -230,7 +237,7 @@ void GameServer::Tick()
 			//If there are two then they are centred on the spawn centre
 			if(enemy_count == 2)
 			{
-				plane_distance = static_cast<float>(150 + Utility::RandomInt(250));
+				plane_distance = static_cast<float>(150 + m_random.NextInt(250));
 				next_spawn_position = spawn_centre - plane_distance / 2.f;
 			}
 
@@ -240,7 +247,7 @@ void GameServer::Tick()
 			{
 				sf::Packet packet;
 				packet << static_cast<sf::Int32>(Server::PacketType::SpawnEnemy);
-				packet << static_cast<sf::Int32>(1 + Utility::RandomInt(static_cast<int>(AircraftType::kAircraftCount) - 1));
+				packet << static_cast<sf::Int32>(1 + m_random.NextInt(static_cast<int>(AircraftType::kAircraftCount) - 1));
 				packet << m_world_height - m_battlefield_rect.top + 500;
 				packet << next_spawn_position;
 
@@ -249,7 +256,7 @@ void GameServer::Tick()
 			}
 
 			m_last_spawn_time = Now();
-			m_time_for_next_spawn = sf::milliseconds(2000 + Utility::RandomInt(6000));
+			m_time_for_next_spawn = sf::milliseconds(2000 + m_random.NextInt(6000));
 		}
 	}
 }
@@ -326,6 +333,31 @@ void GameServer::HandleIncomingPacket(sf::Packet& packet, RemotePeer& receiving_
 	}
 	break;
 
+	case Client::PacketType::PlayerInput:
+	{
+		sf::Int32 tick;
+		sf::Int32 aircraft_identifier;
+		sf::Uint8 input;
+		packet >> tick >> aircraft_identifier >> input;
+
+		sf::Packet relay_packet;
+		relay_packet << static_cast<sf::Int32>(Server::PacketType::PlayerInput) << tick << aircraft_identifier << input;
+		SendToOthers(relay_packet, receiving_peer);
+	}
+	break;
+
+	case Client::PacketType::StateChecksum:
+	{
+		sf::Int32 tick;
+		sf::Uint32 checksum;
+		packet >> tick >> checksum;
+
+		sf::Packet relay_packet;
+		relay_packet << static_cast<sf::Int32>(Server::PacketType::StateChecksum) << tick << checksum;
+		SendToOthers(relay_packet, receiving_peer);
+	}
+	break;
+
 	case Client::PacketType::RequestCoopPartner:
 	{
 		receiving_peer.m_aircraft_identifiers.emplace_back(m_aircraft_identifier_counter);
@@ -337,7 +369,7 @@ void GameServer::HandleIncomingPacket(sf::Packet& packet, RemotePeer& receiving_
 		request_packet << static_cast<sf::Int32>(Server::PacketType::AcceptCoopPartner);
 		request_packet << m_aircraft_identifier_counter;
 
-		float spawn_centre = static_cast<float>(Utility::RandomInt(500) - 250);
+		float spawn_centre = static_cast<float>(m_random.NextInt(500) - 250);
 
 		float plane_distance = 0.f;
 		float next_spawn_position = spawn_centre;
@@ -411,11 +443,11 @@ void GameServer::HandleIncomingPacket(sf::Packet& packet, RemotePeer& receiving_
 
 		//Enemy explodes, with a certain probability, drop a pickup
 		//To avoid multiple messages only listen to the first peer (host)
-		if (action == GameActions::EnemyExplode && Utility::RandomInt(3) == 0 && &receiving_peer == m_peers[0].get())
+		if (action == GameActions::EnemyExplode && m_random.NextInt(3) == 0 && &receiving_peer == m_peers[0].get())
 		{
 			sf::Packet packet;
 			packet << static_cast<sf::Int32>(Server::PacketType::SpawnPickup);
-			packet << static_cast<sf::Int32>(Utility::RandomInt(static_cast<int>(PickupType::kPickupCount)));
+			packet << static_cast<sf::Int32>(m_random.NextInt(static_cast<int>(PickupType::kPickupCount)));
 			packet << x;
 			packet << y;
 
@@ -445,7 +477,7 @@ void GameServer::HandleIncomingConnections()
 		packet << static_cast<sf::Int32>(Server::PacketType::SpawnSelf);
 		packet << m_aircraft_identifier_counter;
 
-		float spawn_centre = static_cast<float>(Utility::RandomInt(1000) - 150);
+		float spawn_centre = static_cast<float>(m_random.NextInt(1000) - 150);
 
 		float plane_distance = 0.f;
 		float next_spawn_position = spawn_centre;
@@ -467,6 +499,11 @@ void GameServer::HandleIncomingConnections()
 
 		m_peers[m_connected_players]->m_aircraft_identifiers.emplace_back(m_aircraft_identifier_counter);
 
+		//The client has to know how the game is networked before anything else arrives
+		sf::Packet mode_packet;
+		mode_packet << static_cast<sf::Int32>(Server::PacketType::NetworkMode) << static_cast<sf::Int32>(m_network_mode);
+		m_peers[m_connected_players]->m_socket.send(mode_packet);
+
 		BroadcastMessage("New player");
 		InformWorldState(m_peers[m_connected_players]->m_socket);
 		NotifyPlayerSpawn(m_aircraft_identifier_counter++);
@@ -568,6 +605,17 @@ void GameServer::SendToAll(sf::Packet& packet)
 	}
 }
 
+void GameServer::SendToOthers(sf::Packet& packet, const RemotePeer& sender)
+{
+	for(PeerPtr& peer : m_peers)
+	{
+		if(peer->m_ready && peer.get() != &sender)
+		{
+			peer->m_socket.send(packet);
+		}
+	}
+}
+
 void GameServer::UpdateClientState()
 {
 	sf::Packet update_client_state_packet;
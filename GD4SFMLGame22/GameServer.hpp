@@ -10,10 +10,13 @@
 #include <SFML/System/Clock.hpp>
 #include <SFML/System/Thread.hpp>
 
+#include "NetworkMode.hpp"
+#include "Random.hpp"
+
 class GameServer
 {
 public:
-	explicit GameServer(sf::Vector2f battlefield_size);
+	GameServer(sf::Vector2f battlefield_size, NetworkMode network_mode);
 	~GameServer();
 	void NotifyPlayerSpawn(sf::Int32 aircraft_identifier);
 	void NotifyPlayerRealtimeChange(sf::Int32 aircraft_identifier, sf::Int32 action, bool action_enabled);
@@ -56,9 +59,11 @@ private:
 	void InformWorldState(sf::TcpSocket& socket);
 	void BroadcastMessage(const std::string& message);
 	void SendToAll(sf::Packet& packet);
+	void SendToOthers(sf::Packet& packet, const RemotePeer& sender);
 	void UpdateClientState();
 
 private:
+	NetworkMode m_network_mode;
 	sf::Thread m_thread;
 	sf::Clock m_clock;
 	sf::TcpListener m_listener_socket;
@@ -81,6 +86,8 @@ private:
 
 	sf::Time m_last_spawn_time;
 	sf::Time m_time_for_next_spawn;
+	//Only the server thread draws from it, spawns and drops are decided here and sent to the clients
+	Random m_random;
 
 	sf::Clock m_start_timer;
 	bool m_timer_finshed;
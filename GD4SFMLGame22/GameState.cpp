@@ -6,7 +6,7 @@
 
 GameState::GameState(StateStack& stack, Context context)
 : State(stack, context)
-, m_world(*context.window, *context.fonts, *context.sounds, false)
+, m_world(*context.window, *context.fonts, *context.sounds, *context.jobs, false)
 , m_player(nullptr, 1, context.keys1)
 {
 	m_world.AddAircraft(1, 0);
@@ -15,9 +15,14 @@ GameState::GameState(StateStack& stack, Context context)
 	context.music->Play(MusicThemes::kMissionTheme);
 }
 
-void GameState::Draw()
+void GameState::Draw(RenderSnapshot& snapshot)
 {
-	m_world.Draw();
+	m_world.Draw(snapshot);
+}
+
+void GameState::SetInterpolation(float alpha)
+{
+	m_world.SetInterpolation(alpha);
 }
 
 bool GameState::Update(sf::Time dt)
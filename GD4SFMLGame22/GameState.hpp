@@ -7,9 +7,10 @@ class GameState : public State
 {
 public:
 	GameState(StateStack& stack, Context context);
-	virtual void Draw();
+	virtual void Draw(RenderSnapshot& snapshot);
 	virtual bool Update(sf::Time dt);
 	virtual bool HandleEvent(const sf::Event& event);
+	virtual void SetInterpolation(float alpha);
 
 private:
 	World m_world;
@@ -0,0 +1,342 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	//A ParallelFor never needs more tasks than there are threads to run them
+	const std::size_t kMaxRangeTasks = 64;
+
+	//Lets a thread find its own queue, threads that are not workers of the system share queue 0
+	thread_local const JobSystem* t_owner = nullptr;
+	thread_local std::size_t t_queue_index = 0;
+}
+
+JobSystem::Task::Task()
+	: m_function(nullptr)
+	, m_context(nullptr)
+	, m_successors(nullptr)
+	, m_successor_count(0)
+	, m_pending_dependencies(0)
+	, m_unfinished(nullptr)
+{
+}
+
+JobSystem::JobSystem(unsigned int worker_count)
+	: m_queued_tasks(0)
+	, m_stopping(false)
+{
+	for (unsigned int i = 0; i <= worker_count; ++i)
+	{
+		m_queues.emplace_back(new Queue());
+	}
+	for (unsigned int i = 1; i <= worker_count; ++i)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerThread, this, i);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+unsigned int JobSystem::GetWorkerCount() const
+{
+	return static_cast<unsigned int>(m_workers.size());
+}
+
+//One worker per remaining core, the thread that starts the work keeps the last one busy
+unsigned int JobSystem::GetDefaultWorkerCount()
+{
+	unsigned int cores = std::thread::hardware_concurrency();
+	return cores > 1 ? cores - 1 : 0;
+}
+
+std::size_t JobSystem::GetThreadIndex() const
+{
+	return GetQueueIndex();
+}
+
+void JobSystem::Run(JobGraph& graph)
+{
+	if (graph.m_nodes.empty())
+	{
+		return;
+	}
+	graph.Prepare();
+
+	const std::size_t count = graph.m_nodes.size();
+	std::atomic<std::size_t> unfinished(count);
+	//Every counter has to be reset before the first job can finish and count its successors down
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		graph.m_tasks[i].m_pending_dependencies = graph.m_nodes[i].m_dependency_count;
+		graph.m_tasks[i].m_unfinished = &unfinished;
+	}
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (graph.m_nodes[i].m_dependency_count == 0)
+		{
+			Push(graph.m_tasks[i]);
+		}
+	}
+	Wait(unfinished);
+}
+
+void JobSystem::ParallelFor(std::size_t count, std::size_t grain_size, RangeFunction function, const void* user_function)
+{
+	grain_size = std::max<std::size_t>(grain_size, 1);
+	const std::size_t range_count = (count + grain_size - 1) / grain_size;
+	if (range_count <= 1 || m_workers.empty())
+	{
+		for (std::size_t begin = 0; begin < count; begin += grain_size)
+		{
+			function(user_function, begin, std::min(begin + grain_size, count));
+		}
+		return;
+	}
+
+	//Each task keeps claiming the next range until there are none left, so uneven ranges balance out
+	RangeBatch batch;
+	batch.m_function = function;
+	batch.m_user_function = user_function;
+	batch.m_count = count;
+	batch.m_grain_size = grain_size;
+	batch.m_next = 0;
+
+	const std::size_t task_count = std::min(std::min(range_count, m_workers.size() + 1), kMaxRangeTasks);
+	Task tasks[kMaxRangeTasks];
+	std::atomic<std::size_t> unfinished(task_count - 1);
+	for (std::size_t i = 1; i < task_count; ++i)
+	{
+		tasks[i].m_function = &JobSystem::RunRanges;
+		tasks[i].m_context = &batch;
+		tasks[i].m_unfinished = &unfinished;
+		Push(tasks[i]);
+	}
+	RunRanges(&batch);
+	Wait(unfinished);
+}
+
+void JobSystem::RunRanges(void* context)
+{
+	RangeBatch& batch = *static_cast<RangeBatch*>(context);
+	while (true)
+	{
+		std::size_t begin = batch.m_next.fetch_add(batch.m_grain_size);
+		if (begin >= batch.m_count)
+		{
+			return;
+		}
+		batch.m_function(batch.m_user_function, begin, std::min(begin + batch.m_grain_size, batch.m_count));
+	}
+}
+
+void JobSystem::Push(Task& task)
+{
+	Queue& queue = *m_queues[GetQueueIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		queue.m_tasks.push_back(&task);
+	}
+	m_queued_tasks.fetch_add(1);
+
+	//Taking the lock orders this push after a worker that is about to sleep has checked the count
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+	}
+	m_wake.notify_one();
+}
+
+//Newest task from the thread's own queue first, it is the most likely to still be in the cache,
+//otherwise the oldest task of another queue
+bool JobSystem::TryRunTask()
+{
+	const std::size_t own = GetQueueIndex();
+	Task* task = nullptr;
+	{
+		Queue& queue = *m_queues[own];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		if (!queue.m_tasks.empty())
+		{
+			task = queue.m_tasks.back();
+			queue.m_tasks.pop_back();
+		}
+	}
+	for (std::size_t offset = 1; task == nullptr && offset < m_queues.size(); ++offset)
+	{
+		Queue& victim = *m_queues[(own + offset) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(victim.m_mutex);
+		if (!victim.m_tasks.empty())
+		{
+			task = victim.m_tasks.front();
+			victim.m_tasks.pop_front();
+		}
+	}
+
+	if (task == nullptr)
+	{
+		return false;
+	}
+	m_queued_tasks.fetch_sub(1);
+	Execute(*task);
+	return true;
+}
+
+void JobSystem::Execute(Task& task)
+{
+	task.m_function(task.m_context);
+	for (std::size_t i = 0; i < task.m_successor_count; ++i)
+	{
+		Task& successor = *task.m_successors[i];
+		if (successor.m_pending_dependencies.fetch_sub(1) == 1)
+		{
+			Push(successor);
+		}
+	}
+	//The waiting thread may free the task as soon as this reaches 0, so it is the last thing touched
+	task.m_unfinished->fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::Wait(const std::atomic<std::size_t>& unfinished)
+{
+	while (unfinished.load(std::memory_order_acquire) != 0)
+	{
+		if (!TryRunTask())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+std::size_t JobSystem::GetQueueIndex() const
+{
+	return t_owner == this ? t_queue_index : 0;
+}
+
+void JobSystem::WorkerThread(std::size_t queue_index)
+{
+	t_owner = this;
+	t_queue_index = queue_index;
+	while (true)
+	{
+		if (TryRunTask())
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleep_mutex);
+		m_wake.wait(lock, [this]
+		{
+			return m_stopping || m_queued_tasks.load() > 0;
+		});
+		if (m_stopping)
+		{
+			return;
+		}
+	}
+}
+
+JobGraph::JobGraph()
+	: m_needs_prepare(true)
+{
+}
+
+JobGraph::NodeId JobGraph::Add(JobSystem::Job job)
+{
+	Node node;
+	node.m_job = std::move(job);
+	node.m_dependency_count = 0;
+	m_nodes.emplace_back(std::move(node));
+	m_needs_prepare = true;
+	return m_nodes.size() - 1;
+}
+
+void JobGraph::Precede(NodeId before, NodeId after)
+{
+	assert(before < m_nodes.size() && after < m_nodes.size() && before != after);
+	m_nodes[before].m_successors.emplace_back(after);
+	m_nodes[after].m_dependency_count += 1;
+	m_needs_prepare = true;
+}
+
+std::size_t JobGraph::GetSize() const
+{
+	return m_nodes.size();
+}
+
+void JobGraph::Prepare()
+{
+	if (!m_needs_prepare)
+	{
+		return;
+	}
+
+	const std::size_t count = m_nodes.size();
+	m_tasks.reset(new JobSystem::Task[count]);
+	m_successor_tasks.clear();
+	for (const Node& node : m_nodes)
+	{
+		for (NodeId successor : node.m_successors)
+		{
+			m_successor_tasks.emplace_back(&m_tasks[successor]);
+		}
+	}
+
+	std::size_t first = 0;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		JobSystem::Task& task = m_tasks[i];
+		task.m_function = &JobGraph::RunNode;
+		task.m_context = &m_nodes[i];
+		task.m_successors = m_successor_tasks.data() + first;
+		task.m_successor_count = m_nodes[i].m_successors.size();
+		first += task.m_successor_count;
+	}
+
+#ifndef NDEBUG
+	//A cycle would leave its jobs waiting on each other forever, check every node can be reached from a root
+	std::vector<std::size_t> pending(count);
+	std::vector<NodeId> ready;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		pending[i] = m_nodes[i].m_dependency_count;
+		if (pending[i] == 0)
+		{
+			ready.emplace_back(i);
+		}
+	}
+	std::size_t reached = 0;
+	while (!ready.empty())
+	{
+		NodeId node = ready.back();
+		ready.pop_back();
+		++reached;
+		for (NodeId successor : m_nodes[node].m_successors)
+		{
+			if (--pending[successor] == 0)
+			{
+				ready.emplace_back(successor);
+			}
+		}
+	}
+	assert(reached == count);
+#endif
+
+	m_needs_prepare = false;
+}
+
+void JobGraph::RunNode(void* context)
+{
+	static_cast<Node*>(context)->m_job();
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobGraph;
+
+//Fixed set of worker threads for short, fine grained jobs
+//Every thread has its own deque of tasks: it pushes and pops at the back, and a thread that runs dry
+//steals from the front of the others. A thread waiting for its jobs runs queued tasks in the meantime,
+//so a job may itself call ParallelFor or Run without tying up a worker
+//Nothing is allocated per call, tasks live on the caller's stack or in the JobGraph
+class JobSystem : private sf::NonCopyable
+{
+public:
+	typedef std::function<void()> Job;
+
+public:
+	//0 workers runs everything on the calling thread
+	explicit JobSystem(unsigned int worker_count = GetDefaultWorkerCount());
+	~JobSystem();
+
+	unsigned int GetWorkerCount() const;
+	static unsigned int GetDefaultWorkerCount();
+	//0 for the thread that started the work, 1 to GetWorkerCount for the workers
+	//Lets jobs keep per thread buffers in an array sized GetWorkerCount() + 1
+	std::size_t GetThreadIndex() const;
+
+	//Calls function(begin, end) over [0, count) in ranges of grain_size, the last one may be shorter
+	//Ranges always start at a multiple of grain_size, so begin / grain_size numbers them deterministically
+	template <typename Function>
+	void ParallelFor(std::size_t count, std::size_t grain_size, const Function& function);
+	//Runs every job in the graph, each one after all the jobs it depends on have finished
+	void Run(JobGraph& graph);
+
+private:
+	friend class JobGraph;
+
+	struct Task
+	{
+		Task();
+
+		void (*m_function)(void* context);
+		void* m_context;
+		Task* const* m_successors;
+		std::size_t m_successor_count;
+		std::atomic<std::size_t> m_pending_dependencies;
+		std::atomic<std::size_t>* m_unfinished;
+	};
+
+	struct Queue
+	{
+		std::mutex m_mutex;
+		std::deque<Task*> m_tasks;
+	};
+
+	typedef void (*RangeFunction)(const void* function, std::size_t begin, std::size_t end);
+
+	struct RangeBatch
+	{
+		RangeFunction m_function;
+		const void* m_user_function;
+		std::size_t m_count;
+		std::size_t m_grain_size;
+		std::atomic<std::size_t> m_next;
+	};
+
+private:
+	void ParallelFor(std::size_t count, std::size_t grain_size, RangeFunction function, const void* user_function);
+	template <typename Function>
+	static void InvokeRange(const void* function, std::size_t begin, std::size_t end);
+	static void RunRanges(void* context);
+
+	void Push(Task& task);
+	bool TryRunTask();
+	void Execute(Task& task);
+	void Wait(const std::atomic<std::size_t>& unfinished);
+	std::size_t GetQueueIndex() const;
+	void WorkerThread(std::size_t queue_index);
+
+private:
+	//Queue 0 belongs to every thread that is not one of the workers
+	std::vector<std::unique_ptr<Queue>> m_queues;
+	std::vector<std::thread> m_workers;
+	std::atomic<std::size_t> m_queued_tasks;
+	std::mutex m_sleep_mutex;
+	std::condition_variable m_wake;
+	bool m_stopping;
+};
+
+//Jobs with dependencies between them, built once and run as often as needed
+class JobGraph : private sf::NonCopyable
+{
+public:
+	typedef std::size_t NodeId;
+
+public:
+	JobGraph();
+
+	NodeId Add(JobSystem::Job job);
+	//after does not start until before has finished
+	void Precede(NodeId before, NodeId after);
+	std::size_t GetSize() const;
+
+private:
+	friend class JobSystem;
+
+	struct Node
+	{
+		JobSystem::Job m_job;
+		std::vector<NodeId> m_successors;
+		std::size_t m_dependency_count;
+	};
+
+private:
+	void Prepare();
+	static void RunNode(void* context);
+
+private:
+	std::vector<Node> m_nodes;
+	//Rebuilt only when nodes or edges change
+	std::unique_ptr<JobSystem::Task[]> m_tasks;
+	std::vector<JobSystem::Task*> m_successor_tasks;
+	bool m_needs_prepare;
+};
+
+#include "JobSystem.inl"
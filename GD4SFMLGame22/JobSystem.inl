@@ -0,0 +1,11 @@
+template <typename Function>
+void JobSystem::ParallelFor(std::size_t count, std::size_t grain_size, const Function& function)
+{
+	ParallelFor(count, grain_size, &JobSystem::InvokeRange<Function>, &function);
+}
+
+template <typename Function>
+void JobSystem::InvokeRange(const void* function, std::size_t begin, std::size_t end)
+{
+	(*static_cast<const Function*>(function))(begin, end);
+}
@@ -73,15 +73,21 @@ std::vector<KeyBinding::Action> KeyBinding::GetRealtimeActions() const
 {
 	// Return all realtime actions that are currently active.
 	std::vector<Action> actions;
+	GetRealtimeActions(actions);
+	return actions;
+}
 
-	for(auto pair : m_key_map)
+void KeyBinding::GetRealtimeActions(std::vector<Action>& actions) const
+{
+	// Fill a caller owned buffer so per frame polling does not allocate
+	actions.clear();
+
+	for(const auto& pair : m_key_map)
 	{
 		// If key is pressed and an action is a realtime action, store it
 		if (sf::Keyboard::isKeyPressed(pair.first) && IsRealtimeAction(pair.second))
 			actions.push_back(pair.second);
 	}
-
-	return actions;
 }
 
 bool IsRealtimeAction(PlayerAction action)
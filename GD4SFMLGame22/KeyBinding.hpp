@@ -19,6 +19,7 @@ public:
 
 	bool					CheckAction(sf::Keyboard::Key key, Action& out) const;
 	std::vector<Action>		GetRealtimeActions() const;
+	void					GetRealtimeActions(std::vector<Action>& actions) const;
 
 
 
@@ -1,8 +1,7 @@
 #include "Label.hpp"
 
 #include "ResourceHolder.hpp"
-#include <SFML/Graphics/RenderStates.hpp>
-#include <SFML/Graphics/RenderTarget.hpp>
+#include "RenderSnapshot.hpp"
 
 namespace GUI
 {
@@ -25,10 +24,10 @@ namespace GUI
 	{
 	}
 
-	void Label::draw(sf::RenderTarget& target, sf::RenderStates states) const
+	void Label::Draw(RenderSnapshot& snapshot, sf::RenderStates states) const
 	{
 		states.transform *= getTransform();
-		target.draw(m_text, states);
+		snapshot.Draw(m_text, states);
 	}
 }
 
@@ -15,9 +15,8 @@ namespace GUI
 		virtual bool IsSelectable() const override;
 		void SetText(const std::string& text);
 		void HandleEvent(const sf::Event& event) override;
+		void Draw(RenderSnapshot& snapshot, sf::RenderStates states) const override;
 
-	private:
-		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 	private:
 		sf::Text m_text;
 	};
@@ -1,11 +1,47 @@
+#include <algorithm>
 #include <iostream>
+#include <string>
 #include "Application.hpp"
+#include "Benchmark.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
+	if (argc > 1 && std::string(argv[1]) == "--benchmark")
+	{
+		return Benchmark::Run();
+	}
+	if (argc > 2 && std::string(argv[1]) == "--check")
+	{
+		return Benchmark::RunCheck(argv[2]);
+	}
+
 	try
 	{
 		Application app;
+		//--simulation-hz N runs the game logic at N updates per second, rendering is interpolated in between
+		for (int i = 1; i + 1 < argc; ++i)
+		{
+			if (std::string(argv[i]) == "--simulation-hz")
+			{
+				app.SetSimulationFrequency(static_cast<unsigned int>(std::max(1, std::stoi(argv[i + 1]))));
+			}
+		}
+		//--stats-csv FILE writes the timings and render counters of every frame to FILE
+		for (int i = 1; i + 1 < argc; ++i)
+		{
+			if (std::string(argv[i]) == "--stats-csv")
+			{
+				app.SetStatisticsCsv(argv[i + 1]);
+			}
+		}
+		//--rollback hosts games with rollback networking instead of the relay server
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::string(argv[i]) == "--rollback")
+			{
+				app.SetNetworkMode(NetworkMode::kRollback);
+			}
+		}
 		app.Run();
 	}
 	catch (std::exception& e)
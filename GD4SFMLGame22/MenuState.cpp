@@ -1,7 +1,6 @@
 #include "MenuState.hpp"
 
-#include <SFML/Graphics/RenderWindow.hpp>
-
+#include "RenderSnapshot.hpp"
 #include "ResourceHolder.hpp"
 #include "Utility.hpp"
 #include "Button.hpp"
@@ -68,12 +67,11 @@ MenuState::MenuState(StateStack& stack, Context context)
 	context.music->Play(MusicThemes::kMenuTheme);
 }
 
-void MenuState::Draw()
+void MenuState::Draw(RenderSnapshot& snapshot)
 {
-	sf::RenderWindow& window = *GetContext().window;
-	window.setView(window.getDefaultView());
-	window.draw(m_background_sprite);
-	window.draw(m_gui_container);
+	snapshot.SetView(snapshot.GetDefaultView());
+	snapshot.Draw(m_background_sprite);
+	m_gui_container.Draw(snapshot, sf::RenderStates::Default);
 	
 }
 
@@ -9,7 +9,7 @@ class MenuState : public State
 {
 public:
 	MenuState(StateStack& stack, Context context);
-	virtual void Draw();
+	virtual void Draw(RenderSnapshot& snapshot);
 	virtual bool Update(sf::Time dt);
 	virtual bool HandleEvent(const sf::Event& event);
 
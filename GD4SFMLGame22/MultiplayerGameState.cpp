@@ -10,6 +10,8 @@
 #include <SFML/Network/Packet.hpp>
 
 #include "PickupType.hpp"
+#include "RenderSnapshot.hpp"
+#include "RenderThread.hpp"
 
 sf::IpAddress GetAddressFromFile()
 {
@@ -32,11 +34,13 @@ sf::IpAddress GetAddressFromFile()
 
 MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, bool is_host)
 : State(stack, context)
-, m_world(*context.window, *context.fonts, *context.sounds, true)
+, m_world(*context.window, *context.fonts, *context.sounds, *context.jobs, true)
 , m_window(*context.window)
 , m_texture_holder(*context.textures)
 , m_connected(false)
 , m_game_server(nullptr)
+, m_rollback_session(nullptr)
+, m_desync_reported(false)
 , m_active_state(true)
 , m_has_focus(true)
 , m_host(is_host)
@@ -62,16 +66,16 @@ MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, b
 	m_failed_connection_text.setPosition(m_window.getSize().x / 2.f, m_window.getSize().y / 2.f);
 
 	//Render an "establishing connection" frame for user feedback
-	m_window.clear(sf::Color::Black);
-	m_window.draw(m_failed_connection_text);
-	m_window.display();
+	RenderSnapshot& snapshot = context.renderer->BeginFrame();
+	snapshot.Draw(m_failed_connection_text);
+	context.renderer->Publish();
 	m_failed_connection_text.setString("Could not connect to the remote server");
 	Utility::CentreOrigin(m_failed_connection_text);
 
 	sf::IpAddress ip;
 	if(m_host)
 	{
-		m_game_server.reset(new GameServer(sf::Vector2f(m_window.getSize())));
+		m_game_server.reset(new GameServer(sf::Vector2f(m_window.getSize()), *context.network_mode));
 		ip = "127.0.0.1";
 	}
 	else
@@ -94,38 +98,49 @@ MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, b
 	context.music->Play(MusicThemes::kMissionTheme);
 }
 
-void MultiplayerGameState::Draw()
+void MultiplayerGameState::Draw(RenderSnapshot& snapshot)
 {
 	if(m_connected)
 	{
-		m_world.Draw();
+		m_world.Draw(snapshot);
 
 		//Show broadcast messages in default view
-		m_window.setView(m_window.getDefaultView());
+		snapshot.SetView(snapshot.GetDefaultView());
 
 		if(!m_broadcasts.empty())
 		{
-			m_window.draw(m_broadcast_text);
+			snapshot.Draw(m_broadcast_text);
 		}
 
 		if(m_local_player_identifiers.size() < 2 && m_player_invitation_time < sf::seconds(0.5f))
 		{
-			m_window.draw(m_player_invitation_text);
+			snapshot.Draw(m_player_invitation_text);
 		}
 	}
 	else
 	{
-		m_window.draw(m_failed_connection_text);
+		snapshot.Draw(m_failed_connection_text);
 	}
 }
 
+void MultiplayerGameState::SetInterpolation(float alpha)
+{
+	m_world.SetInterpolation(alpha);
+}
+
 bool MultiplayerGameState::Update(sf::Time dt)
 {
 	//Connected to the Server: Handle all the network logic
 	if(m_connected)
 	{
-
-		m_world.Update(dt);
+		if(m_rollback_session)
+		{
+			UpdateRollback();
+		}
+		else
+		{
+			m_world.Update(dt);
+		}
 
 		//Remove players whose aircraft were destroyed
 		bool found_local_plane = false;
@@ -144,7 +159,7 @@ bool MultiplayerGameState::Update(sf::Time dt)
 			}
 			else
 			{
-				if(std::find(m_local_player_identifiers.begin(), m_local_player_identifiers.end(), itr->first) != m_local_player_identifiers.end())
+				if(m_world.IsLocalAircraft(itr->first))
 			{
 				found_local_plane = true;
 				//itr->first.get()->GetMissionStatus;
@@ -160,32 +175,42 @@ bool MultiplayerGameState::Update(sf::Time dt)
 			RequestStackPush(StateID::kGameOver);
 		}
 
-		//Only handle the realtime input if the window has focus and the game is unpaused
-		if(m_active_state && m_has_focus)
+		//Rollback sessions sample input themselves, once per tick
+		if(!m_rollback_session)
 		{
+			//Only handle the realtime input if the window has focus and the game is unpaused
+			if(m_active_state && m_has_focus)
+			{
+				CommandQueue& commands = m_world.GetCommandQueue();
+				for(auto& pair : m_players)
+				{
+					pair.second->HandleRealtimeInput(commands);
+				}
+			}
+
+			//Always handle the network input
 			CommandQueue& commands = m_world.GetCommandQueue();
 			for(auto& pair : m_players)
 			{
-				pair.second->HandleRealtimeInput(commands);
+				pair.second->HandleRealtimeNetworkInput(commands);
 			}
 		}
 
-		//Always handle the network input
-		CommandQueue& commands = m_world.GetCommandQueue();
-		for(auto& pair : m_players)
-		{
-			pair.second->HandleRealtimeNetworkInput(commands);
-		}
-
-		//Handle messages from the server that may have arrived
+		//Handle all messages from the server that have arrived, a rollback peer gets every other player's input each tick
 		sf::Packet packet;
-		if(m_socket.receive(packet) == sf::Socket::Done)
+		bool received = false;
+		while(m_socket.receive(packet) == sf::Socket::Done)
 		{
-			m_time_since_last_packet = sf::seconds(0.f);
+			received = true;
 			sf::Int32 packet_type;
 			packet >> packet_type;
 			HandlePacket(packet_type, packet);
 		}
+
+		if(received)
+		{
+			m_time_since_last_packet = sf::seconds(0.f);
+		}
 		else
 		{
 			//Check for timeout with the server
@@ -230,8 +255,8 @@ bool MultiplayerGameState::Update(sf::Time dt)
 		//	
 		//}
 		//std::cout << "Time = " << dt.asSeconds() << std::endl;
-		//Regular position updates
-		if(m_tick_clock.getElapsedTime() > sf::seconds(1.f/20.f))
+		//Regular position updates, rollback peers never need them
+		if(!m_rollback_session && m_tick_clock.getElapsedTime() > sf::seconds(1.f/20.f))
 		{
 			sf::Packet position_update_packet;
 			position_update_packet << static_cast<sf::Int32>(Client::PacketType::PositionUpdate);
@@ -267,7 +292,14 @@ bool MultiplayerGameState::HandleEvent(const sf::Event& event)
 	//Forward events to all players
 	for(auto& pair : m_players)
 	{
-		pair.second->HandleEvent(event, commands);
+		if(m_rollback_session)
+		{
+			pair.second->RecordEvent(event);
+		}
+		else
+		{
+			pair.second->HandleEvent(event, commands);
+		}
 	}
 
 	if(event.type == sf::Event::KeyPressed)
@@ -317,6 +349,11 @@ void MultiplayerGameState::OnDestroy()
 void MultiplayerGameState::DisableAllRealtimeActions()
 {
 	m_active_state = false;
+	if(m_rollback_session)
+	{
+		//Inactive rollback peers send empty input instead
+		return;
+	}
 	for(sf::Int32 identifier : m_local_player_identifiers)
 	{
 		m_players[identifier]->DisableAllRealtimeActions();
@@ -347,6 +384,58 @@ void MultiplayerGameState::UpdateBroadcastMessage(sf::Time elapsed_time)
 	}
 }
 
+void MultiplayerGameState::AddBroadcastMessage(const std::string& message)
+{
+	m_broadcasts.push_back(message);
+
+	//Just added the first message, display immediately
+	if (m_broadcasts.size() == 1)
+	{
+		m_broadcast_text.setString(m_broadcasts.front());
+		Utility::CentreOrigin(m_broadcast_text);
+		m_broadcast_elapsed_time = sf::Time::Zero;
+	}
+}
+
+//Every peer starts ticking when the match starts, until then the world holds still so they all start from the same state
+void MultiplayerGameState::UpdateRollback()
+{
+	if(!m_world.HasGameStarted() || !m_rollback_session->CanAdvance())
+	{
+		return;
+	}
+
+	for(sf::Int32 identifier : m_local_player_identifiers)
+	{
+		RollbackSession::Input input = m_players[identifier]->TakeInput();
+		if(!m_active_state || !m_has_focus)
+		{
+			input = 0;
+		}
+		RollbackSession::Tick tick = m_rollback_session->AddLocalInput(identifier, input);
+
+		sf::Packet packet;
+		packet << static_cast<sf::Int32>(Client::PacketType::PlayerInput) << tick << identifier << static_cast<sf::Uint8>(input);
+		m_socket.send(packet);
+	}
+	m_rollback_session->Advance();
+
+	RollbackSession::Tick tick;
+	std::uint32_t checksum;
+	while(m_rollback_session->PollChecksum(tick, checksum))
+	{
+		sf::Packet packet;
+		packet << static_cast<sf::Int32>(Client::PacketType::StateChecksum) << tick << static_cast<sf::Uint32>(checksum);
+		m_socket.send(packet);
+	}
+
+	if(m_rollback_session->HasDesynced() && !m_desync_reported)
+	{
+		m_desync_reported = true;
+		AddBroadcastMessage("Out of sync with another player");
+	}
+}
+
 void MultiplayerGameState::HandlePacket(sf::Int32 packet_type, sf::Packet& packet)
 {
 	switch (static_cast<Server::PacketType>(packet_type))
@@ -356,14 +445,50 @@ void MultiplayerGameState::HandlePacket(sf::Int32 packet_type, sf::Packet& packe
 	{
 		std::string message;
 		packet >> message;
-		m_broadcasts.push_back(message);
+		AddBroadcastMessage(message);
+	}
+	break;
 
-		//Just added the first message, display immediately
-		if (m_broadcasts.size() == 1)
+	//Sent first thing after connecting, the host decides how the game is networked
+	case Server::PacketType::NetworkMode:
+	{
+		sf::Int32 mode;
+		packet >> mode;
+		if (static_cast<NetworkMode>(mode) == NetworkMode::kRollback)
 		{
-			m_broadcast_text.setString(m_broadcasts.front());
-			Utility::CentreOrigin(m_broadcast_text);
-			m_broadcast_elapsed_time = sf::Time::Zero;
+			m_rollback_session.reset(new RollbackSession(m_world, *GetContext().time_per_update, [this](int identifier, RollbackSession::Input input, CommandQueue& commands)
+			{
+				auto itr = m_players.find(identifier);
+				if (itr != m_players.end())
+				{
+					itr->second->ApplyInput(input, commands);
+				}
+			}));
+		}
+	}
+	break;
+
+	case Server::PacketType::PlayerInput:
+	{
+		sf::Int32 tick;
+		sf::Int32 aircraft_identifier;
+		sf::Uint8 input;
+		packet >> tick >> aircraft_identifier >> input;
+		if (m_rollback_session)
+		{
+			m_rollback_session->AddRemoteInput(aircraft_identifier, tick, input);
+		}
+	}
+	break;
+
+	case Server::PacketType::StateChecksum:
+	{
+		sf::Int32 tick;
+		sf::Uint32 checksum;
+		packet >> tick >> checksum;
+		if (m_rollback_session)
+		{
+			m_rollback_session->CheckRemoteChecksum(tick, checksum);
 		}
 	}
 	break;
@@ -380,6 +505,11 @@ void MultiplayerGameState::HandlePacket(sf::Int32 packet_type, sf::Packet& packe
 		//aircraft->SetTeamPink(TeamPink);
 		m_players[aircraft_identifier].reset(new Player(&m_socket, aircraft_identifier, GetContext().keys1));
 		m_local_player_identifiers.push_back(aircraft_identifier);
+		if (m_rollback_session)
+		{
+			m_rollback_session->AddPlayer(aircraft_identifier, true);
+		}
+		m_world.SetLocalAircraft(aircraft_identifier);
 		m_game_started = true;
 	}
 	break;
@@ -395,15 +525,24 @@ void MultiplayerGameState::HandlePacket(sf::Int32 packet_type, sf::Packet& packe
 		aircraft->setPosition(aircraft_position);
 		//aircraft->SetTeamPink(TeamPink);
 		m_players[aircraft_identifier].reset(new Player(&m_socket, aircraft_identifier, nullptr));
+		if (m_rollback_session)
+		{
+			m_rollback_session->AddPlayer(aircraft_identifier, false);
+		}
 	}
 	break;
 
+	//A rollback peer leaving mid match removes their aircraft at a different tick on every peer, the checksums will report it
 	case Server::PacketType::PlayerDisconnect:
 	{
 		sf::Int32 aircraft_identifier;
 		packet >> aircraft_identifier;
 		m_world.RemoveAircraft(aircraft_identifier);
 		m_players.erase(aircraft_identifier);
+		if (m_rollback_session)
+		{
+			m_rollback_session->RemovePlayer(aircraft_identifier);
+		}
 	}
 	break;
 
@@ -428,12 +567,21 @@ void MultiplayerGameState::HandlePacket(sf::Int32 packet_type, sf::Packet& packe
 
 			Aircraft* aircraft = m_world.AddAircraft(aircraft_identifier, TeamPink);
 			aircraft->setPosition(aircraft_position);
-			aircraft->SetHitpoints(hitpoints);
-			aircraft->SetMissileAmmo(missile_ammo);
+			//The server's figures for a rollback game are only its spawn defaults, the aircraft must start
+			//exactly as it did on the peer that spawned it
+			if (!m_rollback_session)
+			{
+				aircraft->SetHitpoints(hitpoints);
+				aircraft->SetMissileAmmo(missile_ammo);
+			}
 			//aircraft->SetTeamPink(TeamPink);
 			//aircraft->SetTeamPink(aircraft->GetTeamPink());
 
 			m_players[aircraft_identifier].reset(new Player(&m_socket, aircraft_identifier, nullptr));
+			if (m_rollback_session)
+			{
+				m_rollback_session->AddPlayer(aircraft_identifier, false);
+			}
 		}
 	}
 	break;
@@ -446,6 +594,7 @@ void MultiplayerGameState::HandlePacket(sf::Int32 packet_type, sf::Packet& packe
 		//m_world.AddAircraft(aircraft_identifier);
 		m_players[aircraft_identifier].reset(new Player(&m_socket, aircraft_identifier, GetContext().keys2));
 		m_local_player_identifiers.emplace_back(aircraft_identifier);
+		m_world.SetLocalAircraft(aircraft_identifier);
 	}
 	break;
 
@@ -538,11 +687,11 @@ void MultiplayerGameState::HandlePacket(sf::Int32 packet_type, sf::Packet& packe
 			packet >> aircraft_identifier >> aircraft_position.x >> aircraft_position.y >> hitpoints >> ammo;
 
 			Aircraft* aircraft = m_world.GetAircraft(aircraft_identifier);
-			bool is_local_plane = std::find(m_local_player_identifiers.begin(), m_local_player_identifiers.end(), aircraft_identifier) != m_local_player_identifiers.end();
+			bool is_local_plane = m_world.IsLocalAircraft(aircraft_identifier);
 			if(aircraft && !is_local_plane)
 			{
 				sf::Vector2f interpolated_position = aircraft->getPosition() + (aircraft_position - aircraft->getPosition()) * 0.1f;
-				aircraft->setPosition(interpolated_position);
+				aircraft->TravelTo(interpolated_position);
 				aircraft->SetHitpoints(hitpoints);
 				aircraft->SetMissileAmmo(ammo);
 			}
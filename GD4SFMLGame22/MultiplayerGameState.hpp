@@ -4,13 +4,15 @@
 #include "Player.hpp"
 #include "GameServer.hpp"
 #include "NetworkProtocol.hpp"
+#include "RollbackSession.hpp"
 
 class MultiplayerGameState : public State
 {
 public:
 	MultiplayerGameState(StateStack& stack, Context context, bool is_host);
-	virtual void Draw();
+	virtual void Draw(RenderSnapshot& snapshot);
 	virtual bool Update(sf::Time dt);
+	virtual void SetInterpolation(float alpha);
 	virtual bool HandleEvent(const sf::Event& event);
 	virtual void OnActivate();
 	void OnDestroy();
@@ -18,6 +20,8 @@ public:
 
 private:
 	void UpdateBroadcastMessage(sf::Time elapsed_time);
+	void AddBroadcastMessage(const std::string& message);
+	void UpdateRollback();
 	void HandlePacket(sf::Int32 packet_type, sf::Packet& packet);
 
 private:
@@ -33,6 +37,9 @@ private:
 	sf::TcpSocket m_socket;
 	bool m_connected;
 	std::unique_ptr<GameServer> m_game_server;
+	//Only set when the host runs the game with rollback networking
+	std::unique_ptr<RollbackSession> m_rollback_session;
+	bool m_desync_reported;
 	sf::Clock m_tick_clock;
 
 	std::vector<std::string> m_broadcasts;
@@ -0,0 +1,9 @@
+#pragma once
+//How the peers of a multiplayer game keep their worlds in step, chosen by the host
+enum class NetworkMode
+{
+	//The server relays input changes and position updates
+	kRelay,
+	//Peers exchange tick stamped inputs and roll back on a misprediction, see RollbackSession
+	kRollback
+};
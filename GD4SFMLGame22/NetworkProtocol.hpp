@@ -20,7 +20,10 @@ namespace Server
 		SpawnSelf,
 		UpdateClientState,
 		MissionSuccess,
-		StartGame
+		StartGame,
+		NetworkMode,
+		PlayerInput,
+		StateChecksum
 	};
 }
 
@@ -34,7 +37,9 @@ namespace Client
 		RequestCoopPartner,
 		PositionUpdate,
 		GameEvent,
-		Quit
+		Quit,
+		PlayerInput,
+		StateChecksum
 	};
 }
 
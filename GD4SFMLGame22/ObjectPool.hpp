@@ -0,0 +1,30 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "SceneNode.hpp"
+
+//Free list of scene nodes of one type
+//Acquire hands out a recycled node after calling its Reset with the same arguments the constructor takes,
+//or constructs a new one when the free list is empty. Nodes come back through SceneNode::Dispose
+template <typename Object>
+class ObjectPool : public SceneNode::Recycler, private sf::NonCopyable
+{
+public:
+	typedef std::unique_ptr<Object> Ptr;
+
+public:
+	template <typename... Args>
+	Ptr Acquire(Args&&... args);
+	virtual void Recycle(SceneNode::Ptr node) override;
+
+	std::size_t GetFreeCount() const;
+
+private:
+	std::vector<Ptr> m_free_list;
+};
+
+#include "ObjectPool.inl"
@@ -0,0 +1,32 @@
+template <typename Object>
+template <typename... Args>
+typename ObjectPool<Object>::Ptr ObjectPool<Object>::Acquire(Args&&... args)
+{
+	Ptr object;
+	if (m_free_list.empty())
+	{
+		object.reset(new Object(std::forward<Args>(args)...));
+	}
+	else
+	{
+		//Reuse the most recently released object, it is the most likely to still be in the cache
+		object = std::move(m_free_list.back());
+		m_free_list.pop_back();
+		object->Reset(std::forward<Args>(args)...);
+	}
+	object->SetRecycler(this);
+	return object;
+}
+
+template <typename Object>
+void ObjectPool<Object>::Recycle(SceneNode::Ptr node)
+{
+	//Only nodes handed out by Acquire point back at this pool, so the cast is safe
+	m_free_list.emplace_back(static_cast<Object*>(node.release()));
+}
+
+template <typename Object>
+std::size_t ObjectPool<Object>::GetFreeCount() const
+{
+	return m_free_list.size();
+}
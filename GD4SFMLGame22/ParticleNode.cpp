@@ -1,35 +1,60 @@
 #include "ParticleNode.hpp"
 #include "DataTables.hpp"
+#include "JobSystem.hpp"
+#include "RenderSnapshot.hpp"
 #include "ResourceHolder.hpp"
 
-#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
 #include <algorithm>
+#include <cassert>
 
 
 namespace
 {
 	const std::vector<ParticleData> Table = InitializeParticleData();
+
+	//Two triangles per particle, so the quads stay separate when drawn as one array
+	const std::size_t kVerticesPerParticle = 6;
+	//Below a few thousand particles the fill is quicker than handing it out to the workers
+	const std::size_t kVertexGrainSize = 4096;
 }
 
-ParticleNode::ParticleNode(ParticleType type, const TextureHolder& textures)
+const std::size_t ParticleNode::kDefaultCapacity = 8192;
+
+ParticleNode::ParticleNode(ParticleType type, const TextureHolder& textures, JobSystem& jobs, std::size_t capacity)
 	: SceneNode()
 	, m_texture(textures.Get(Textures::kParticle))
 	, m_type(type)
-	, m_vertex_array(sf::TriangleStrip)
+	, m_jobs(jobs)
+	, m_colour(Table[static_cast<int>(type)].m_color)
+	, m_lifetime(Table[static_cast<int>(type)].m_lifetime.asSeconds())
+	, m_time(0.f)
+	, m_positions(capacity)
+	, m_birth_times(capacity)
+	, m_first(0)
+	, m_count(0)
+	, m_vertices(capacity * kVerticesPerParticle)
 	, m_needs_vertex_update(true)
 {
+	assert(capacity > 0);
 }
 
 void ParticleNode::AddParticle(sf::Vector2f position)
 {
-	Particle particle;
-	particle.m_position = position;
-	particle.m_colour = Table[static_cast<int>(m_type)].m_color;
-	particle.m_lifetime = Table[static_cast<int>(m_type)].m_lifetime;
+	const std::size_t capacity = m_positions.size();
+	if (m_count == capacity)
+	{
+		//Full, the newest particle takes the place of the oldest
+		m_first = (m_first + 1) % capacity;
+		--m_count;
+	}
 
-	m_particles.emplace_back(particle);
+	const std::size_t slot = GetSlot(m_count);
+	m_positions[slot] = position;
+	m_birth_times[slot] = m_time;
+	++m_count;
+	m_needs_vertex_update = true;
 }
 
 ParticleType ParticleNode::GetParticleType() const
@@ -37,6 +62,11 @@ ParticleType ParticleNode::GetParticleType() const
 	return m_type;
 }
 
+std::size_t ParticleNode::GetParticleCount() const
+{
+	return m_count;
+}
+
 unsigned int ParticleNode::GetCategory() const
 {
 	return Category::kParticleSystem;
@@ -44,21 +74,26 @@ unsigned int ParticleNode::GetCategory() const
 
 void ParticleNode::UpdateCurrent(sf::Time dt, CommandQueue&)
 {
-	// Remove expired particles at beginning
-	while (!m_particles.empty() && m_particles.front().m_lifetime <= sf::Time::Zero)
-		m_particles.pop_front();
+	m_time += dt.asSeconds();
 
-	// Decrease lifetime of existing particles
-	for (Particle& particle : m_particles)
+	//Remove expired particles, they are in order of age so only the front needs checking
+	const std::size_t capacity = m_positions.size();
+	while (m_count > 0 && m_time - m_birth_times[m_first] >= m_lifetime)
 	{
-		particle.m_lifetime -= dt;
+		m_first = (m_first + 1) % capacity;
+		--m_count;
 	}
 
 	m_needs_vertex_update = true;
 }
 
-void ParticleNode::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void ParticleNode::DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const
 {
+	if (m_count == 0)
+	{
+		return;
+	}
+
 	if (m_needs_vertex_update)
 	{
 		ComputeVertices();
@@ -69,37 +104,67 @@ void ParticleNode::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states
 	states.texture = &m_texture;
 
 	// Draw vertices
-	target.draw(m_vertex_array, states);
+	snapshot.Draw(m_vertices.data(), m_count * kVerticesPerParticle, sf::Triangles, states);
 }
 
-void ParticleNode::AddVertex(float worldX, float worldY, float texCoordX, float texCoordY, const sf::Color& color) const
+//Particles are stored in world coordinates, each one a texture sized quad around its position
+sf::FloatRect ParticleNode::GetDrawBounds() const
 {
-	sf::Vertex vertex;
-	vertex.position = sf::Vector2f(worldX, worldY);
-	vertex.texCoords = sf::Vector2f(texCoordX, texCoordY);
-	vertex.color = color;
+	if (m_count == 0)
+	{
+		return sf::FloatRect();
+	}
 
-	m_vertex_array.append(vertex);
+	sf::Vector2f min = m_positions[m_first];
+	sf::Vector2f max = min;
+	for (std::size_t i = 0; i < m_count; ++i)
+	{
+		const sf::Vector2f position = m_positions[GetSlot(i)];
+		min.x = std::min(min.x, position.x);
+		min.y = std::min(min.y, position.y);
+		max.x = std::max(max.x, position.x);
+		max.y = std::max(max.y, position.y);
+	}
+	const sf::Vector2f half = sf::Vector2f(m_texture.getSize()) / 2.f;
+	return sf::FloatRect(min - half, max - min + half * 2.f);
+}
+
+//Ring buffer slot of the particle'th oldest particle
+std::size_t ParticleNode::GetSlot(std::size_t particle) const
+{
+	const std::size_t slot = m_first + particle;
+	return slot < m_positions.size() ? slot : slot - m_positions.size();
 }
 
 void ParticleNode::ComputeVertices() const
 {
-	sf::Vector2f size(m_texture.getSize());
-	sf::Vector2f half = size / 2.f;
+	const sf::Vector2f size(m_texture.getSize());
+	const sf::Vector2f half = size / 2.f;
+	const float inverse_lifetime = 1.f / m_lifetime;
 
-	// Refill vertex array
-	m_vertex_array.clear();
-	for(const Particle & particle :  m_particles)
+	//Each range writes its own stretch of the buffer, nothing is shared between the threads
+	m_jobs.ParallelFor(m_count, kVertexGrainSize, [&](std::size_t begin, std::size_t end)
 	{
-		sf::Vector2f pos = particle.m_position;
-		sf::Color color = particle.m_colour;
-
-		float ratio = particle.m_lifetime.asSeconds() / Table[static_cast<int>(m_type)].m_lifetime.asSeconds();
-		color.a = static_cast<sf::Uint8>(255 * std::max(ratio, 0.f));
-
-		AddVertex(pos.x - half.x, pos.y - half.y, 0.f, 0.f, color);
-		AddVertex(pos.x + half.x, pos.y - half.y, size.x, 0.f, color);
-		AddVertex(pos.x + half.x, pos.y + half.y, size.x, size.y, color);
-		AddVertex(pos.x - half.x, pos.y + half.y, 0.f, size.y, color);
-	}
-}
\ No newline at end of file
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			const std::size_t slot = GetSlot(i);
+			const sf::Vector2f position = m_positions[slot];
+			sf::Color colour = m_colour;
+			const float ratio = 1.f - (m_time - m_birth_times[slot]) * inverse_lifetime;
+			colour.a = static_cast<sf::Uint8>(255 * std::max(ratio, 0.f));
+
+			const sf::Vertex top_left(sf::Vector2f(position.x - half.x, position.y - half.y), colour, sf::Vector2f(0.f, 0.f));
+			const sf::Vertex top_right(sf::Vector2f(position.x + half.x, position.y - half.y), colour, sf::Vector2f(size.x, 0.f));
+			const sf::Vertex bottom_right(sf::Vector2f(position.x + half.x, position.y + half.y), colour, sf::Vector2f(size.x, size.y));
+			const sf::Vertex bottom_left(sf::Vector2f(position.x - half.x, position.y + half.y), colour, sf::Vector2f(0.f, size.y));
+
+			sf::Vertex* quad = &m_vertices[i * kVerticesPerParticle];
+			quad[0] = top_left;
+			quad[1] = top_right;
+			quad[2] = bottom_left;
+			quad[3] = bottom_left;
+			quad[4] = top_right;
+			quad[5] = bottom_right;
+		}
+	});
+}
@@ -1,36 +1,57 @@
 #pragma once
 #include <SFML/Graphics/Color.hpp>
-#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <cstddef>
+#include <vector>
 
-#include "Particle.hpp"
 #include "SceneNode.hpp"
 #include "ResourceIdentifiers.hpp"
 #include "ParticleType.hpp"
 
+class JobSystem;
+
+//Particles of one type, kept as structure of arrays in a fixed capacity ring buffer
+//They all live equally long, so the oldest is always at the front: expiring pops from the front and
+//a full buffer overwrites the oldest. A particle only stores when it was born, its fade is worked out from its age
+//The quads are written into a vertex buffer allocated up front, by the worker threads once there are enough of them
 class ParticleNode : public SceneNode
 {
 public:
-	ParticleNode(ParticleType type, const TextureHolder& textures);
+	static const std::size_t kDefaultCapacity;
+
+public:
+	ParticleNode(ParticleType type, const TextureHolder& textures, JobSystem& jobs, std::size_t capacity = kDefaultCapacity);
 
 	void AddParticle(sf::Vector2f position);
 	ParticleType GetParticleType() const;
+	std::size_t GetParticleCount() const;
 	virtual unsigned int GetCategory() const;
 
 
 private:
 	virtual void UpdateCurrent(sf::Time dt, CommandQueue& commands);
-	virtual void DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual void DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const;
+	virtual sf::FloatRect GetDrawBounds() const;
 
-	void AddVertex(float worldX, float worldY, float texCoordX, float texCoordY, const sf::Color& color) const;
+	std::size_t GetSlot(std::size_t particle) const;
 	void ComputeVertices() const;
 
 
 private:
-	std::deque<Particle> m_particles;
 	const sf::Texture& m_texture;
 	ParticleType m_type;
-
-	mutable sf::VertexArray	m_vertex_array;
+	JobSystem& m_jobs;
+	sf::Color m_colour;
+	float m_lifetime;
+	//Seconds this node has been updated for, birth times are measured on it
+	float m_time;
+
+	std::vector<sf::Vector2f> m_positions;
+	std::vector<float> m_birth_times;
+	std::size_t m_first;
+	std::size_t m_count;
+
+	mutable std::vector<sf::Vertex> m_vertices;
 	mutable bool m_needs_vertex_update;
 };
-
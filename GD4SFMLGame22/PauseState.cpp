@@ -6,6 +6,7 @@
 #include <SFML/Graphics/View.hpp>
 
 #include "Button.hpp"
+#include "RenderSnapshot.hpp"
 #include "Utility.hpp"
 
 
@@ -51,18 +52,17 @@ PauseState::~PauseState()
 	GetContext().music->SetPaused(false);
 }
 
-void PauseState::Draw()
+void PauseState::Draw(RenderSnapshot& snapshot)
 {
-	sf::RenderWindow& window = *GetContext().window;
-	window.setView(window.getDefaultView());
+	snapshot.SetView(snapshot.GetDefaultView());
 
 	sf::RectangleShape backgroundShape;
 	backgroundShape.setFillColor(sf::Color(0, 0, 0, 150));
-	backgroundShape.setSize(window.getView().getSize());
+	backgroundShape.setSize(snapshot.GetDefaultView().getSize());
 
-	window.draw(backgroundShape);
-	window.draw(m_paused_text);
-	window.draw(m_gui_container);
+	snapshot.Draw(backgroundShape);
+	snapshot.Draw(m_paused_text);
+	m_gui_container.Draw(snapshot, sf::RenderStates::Default);
 }
 
 bool PauseState::Update(sf::Time)
@@ -12,7 +12,7 @@ public:
 	PauseState(StateStack& stack, Context context, bool lets_updates_through = false);
 	~PauseState();
 
-	virtual void		Draw();
+	virtual void		Draw(RenderSnapshot& snapshot);
 	virtual bool		Update(sf::Time dt);
 	virtual bool		HandleEvent(const sf::Event& event);
 
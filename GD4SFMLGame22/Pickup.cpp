@@ -1,8 +1,8 @@
 #include "Pickup.hpp"
 
-#include <SFML/Graphics/RenderTarget.hpp>
 
 #include "DataTables.hpp"
+#include "RenderSnapshot.hpp"
 #include "ResourceHolder.hpp"
 #include "Utility.hpp"
 
@@ -12,20 +12,22 @@ namespace
 }
 
 
-Pickup::Pickup(PickupType type, const TextureHolder& textures)
+Pickup::Pickup(PickupType type, const TextureHolder& textures, int index)
 	: Entity(1)
 	, m_type(type)
+	, m_index(index)
 	, m_sprite(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect)
 {
 	Utility::CentreOrigin(m_sprite);
 }
 
-Pickup::Pickup(PickupType type, const TextureHolder& textures, int index)
-	: Entity(1)
-	, m_type(type)
-	, m_index(index)
-	, m_sprite(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect)
+void Pickup::Reset(PickupType type, const TextureHolder& textures, int index)
 {
+	Entity::Reset(1);
+	m_type = type;
+	m_index = index;
+	m_sprite.setTexture(textures.Get(Table[static_cast<int>(type)].m_texture));
+	m_sprite.setTextureRect(Table[static_cast<int>(type)].m_texture_rect);
 	Utility::CentreOrigin(m_sprite);
 }
 
@@ -34,6 +36,11 @@ unsigned Pickup::GetCategory() const
 	return Category::Type::kPickup;
 }
 
+sf::FloatRect Pickup::GetDrawBounds() const
+{
+	return m_sprite.getGlobalBounds();
+}
+
 sf::FloatRect Pickup::GetBoundingRect() const
 {
 	return GetWorldTransform().transformRect(m_sprite.getGlobalBounds());
@@ -46,12 +53,17 @@ void Pickup::Apply(Aircraft& player) const
 	Table[static_cast<int>(m_type)].m_action(player);
 }
 
-void Pickup::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void Pickup::DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const
 {
-	target.draw(m_sprite, states);
+	snapshot.Draw(m_sprite, states);
 }
 
-int Pickup::GetIndex()
+int Pickup::GetIndex() const
 {
 	return m_index;
 }
+
+PickupType Pickup::GetType() const
+{
+	return m_type;
+}
@@ -10,13 +10,15 @@ class Aircraft;
 class Pickup : public Entity
 {
 public:
-	Pickup(PickupType type, const TextureHolder& textures);
-	Pickup(PickupType type, const TextureHolder& textures,int index);
+	Pickup(PickupType type, const TextureHolder& textures, int index = 0);
+	void Reset(PickupType type, const TextureHolder& textures, int index = 0);
 	virtual unsigned int GetCategory() const override;
 	virtual sf::FloatRect GetBoundingRect() const;
 	void Apply(Aircraft& player) const;
-	virtual void DrawCurrent(sf::RenderTarget&, sf::RenderStates states) const override;
-	int GetIndex();
+	virtual void DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const override;
+	virtual sf::FloatRect GetDrawBounds() const override;
+	int GetIndex() const;
+	PickupType GetType() const;
 
 private:
 	PickupType m_type;
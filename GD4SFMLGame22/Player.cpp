@@ -6,73 +6,55 @@
 
 struct AircraftMover
 {
-	AircraftMover(float vx, float vy, int identifier)
+	AircraftMover(float vx, float vy)
 	: velocity(vx, vy)
-	, aircraft_id(identifier)
 	{
 		
 	}
 
 	void operator()(Aircraft& aircraft, sf::Time) const
 	{
-		if (aircraft.GetIdentifier() == aircraft_id)
-		{
-			aircraft.Accelerate(velocity * aircraft.GetMaxSpeed());
-		}
+		aircraft.Accelerate(velocity * aircraft.GetMaxSpeed());
 	}
 
 	sf::Vector2f velocity;
-	int aircraft_id;
 };
 
 struct AircraftFireTrigger
 {
-	AircraftFireTrigger(int identifier)
-		: aircraft_id(identifier)
-	{
-	}
-
 	void operator() (Aircraft& aircraft, sf::Time) const
 	{
-		if (aircraft.GetIdentifier() == aircraft_id) 
-		{
-			aircraft.Fire();
-		}
+		aircraft.Fire();
 	}
-
-	int aircraft_id;
 };
 
 struct AircraftMissileTrigger
 {
-	AircraftMissileTrigger(int identifier)
-		: aircraft_id(identifier)
-	{
-	}
-
 	void operator() (Aircraft& aircraft, sf::Time) const
 	{
-		if (aircraft.GetIdentifier() == aircraft_id)
-			aircraft.LaunchMissile();
+		aircraft.LaunchMissile();
 	}
-
-	int aircraft_id;
 };
 
 
 
 Player::Player(sf::TcpSocket* socket, sf::Int32 identifier, const KeyBinding* binding)
 	: m_key_binding(binding)
+	, m_recorded_input(0)
 	, m_current_mission_status(MissionStatus::kMissionRunning)
 	, m_identifier(identifier)
 	, m_socket(socket)
 {
 	// Set initial action bindings
 	InitialiseActions();
+	m_active_actions.reserve(static_cast<int>(PlayerAction::kActionCount));
 
-	// Assign all categories to player's aircraft
+	// Assign all categories to player's aircraft, addressed to this player's aircraft only
 	for(auto & pair : m_action_binding)
+	{
 		pair.second.category = Category::kPlayerAircraft;
+		pair.second.target_identifier = m_identifier;
+	}
 }
 
 
@@ -145,8 +127,8 @@ void Player::HandleRealtimeInput(CommandQueue& commands)
 	if ((m_socket && IsLocal()) || !m_socket)
 	{
 		// Lookup all actions and push corresponding commands to queue
-		std::vector<PlayerAction> activeActions = m_key_binding->GetRealtimeActions();
-		for(PlayerAction action : activeActions)
+		m_key_binding->GetRealtimeActions(m_active_actions);
+		for(PlayerAction action : m_active_actions)
 			commands.Push(m_action_binding[action]);
 	}
 }
@@ -156,7 +138,7 @@ void Player::HandleRealtimeNetworkInput(CommandQueue& commands)
 	if (m_socket && !IsLocal())
 	{
 		// Traverse all realtime input proxies. Because this is a networked game, the input isn't handled directly
-		for(auto pair : m_action_proxies)
+		for(const auto& pair : m_action_proxies)
 		{
 			if (pair.second && IsRealtimeAction(pair.first))
 				commands.Push(m_action_binding[pair.first]);
@@ -175,6 +157,44 @@ void Player::HandleNetworkRealtimeChange(PlayerAction action, bool actionEnabled
 }
 
 
+void Player::RecordEvent(const sf::Event& event)
+{
+	PlayerAction action;
+	if (event.type == sf::Event::KeyPressed && m_key_binding && m_key_binding->CheckAction(event.key.code, action) && !IsRealtimeAction(action))
+	{
+		m_recorded_input |= 1 << static_cast<int>(action);
+	}
+}
+
+//The held realtime actions and the one-shot actions recorded since the last call
+std::uint8_t Player::TakeInput()
+{
+	if (!IsLocal())
+	{
+		return 0;
+	}
+
+	std::uint8_t input = m_recorded_input;
+	m_recorded_input = 0;
+	m_key_binding->GetRealtimeActions(m_active_actions);
+	for (PlayerAction action : m_active_actions)
+	{
+		input |= 1 << static_cast<int>(action);
+	}
+	return input;
+}
+
+void Player::ApplyInput(std::uint8_t input, CommandQueue& commands)
+{
+	for (int action = 0; action < static_cast<int>(PlayerAction::kActionCount); ++action)
+	{
+		if (input & (1 << action))
+		{
+			commands.Push(m_action_binding[static_cast<PlayerAction>(action)]);
+		}
+	}
+}
+
 void Player::SetMissionStatus(MissionStatus status)
 {
 	m_current_mission_status = status;
@@ -187,12 +207,12 @@ MissionStatus Player::GetMissionStatus() const
 
 void Player::InitialiseActions()
 {
-	m_action_binding[PlayerAction::kMoveLeft].action = DerivedAction<Aircraft>(AircraftMover(-1, 0, m_identifier));
-	m_action_binding[PlayerAction::kMoveRight].action = DerivedAction<Aircraft>(AircraftMover(+1, 0, m_identifier));
-	m_action_binding[PlayerAction::kMoveUp].action = DerivedAction<Aircraft>(AircraftMover(0, -1, m_identifier));
-	m_action_binding[PlayerAction::kMoveDown].action = DerivedAction<Aircraft>(AircraftMover(0, +1, m_identifier));
-	m_action_binding[PlayerAction::kFire].action = DerivedAction<Aircraft>(AircraftFireTrigger(m_identifier));
-	m_action_binding[PlayerAction::kLaunchMissile].action = DerivedAction<Aircraft>(AircraftMissileTrigger(m_identifier));
+	m_action_binding[PlayerAction::kMoveLeft].action = DerivedAction<Aircraft>(AircraftMover(-1, 0));
+	m_action_binding[PlayerAction::kMoveRight].action = DerivedAction<Aircraft>(AircraftMover(+1, 0));
+	m_action_binding[PlayerAction::kMoveUp].action = DerivedAction<Aircraft>(AircraftMover(0, -1));
+	m_action_binding[PlayerAction::kMoveDown].action = DerivedAction<Aircraft>(AircraftMover(0, +1));
+	m_action_binding[PlayerAction::kFire].action = DerivedAction<Aircraft>(AircraftFireTrigger());
+	m_action_binding[PlayerAction::kLaunchMissile].action = DerivedAction<Aircraft>(AircraftMissileTrigger());
 }
 
 
@@ -3,7 +3,9 @@
 #include "KeyBinding.hpp"
 #include <SFML/Network/TcpSocket.hpp>
 #include <SFML/Window/Event.hpp>
+#include <cstdint>
 #include <map>
+#include <vector>
 #include "CommandQueue.hpp"
 #include "MissionStatus.hpp"
 #include "PlayerAction.hpp"
@@ -20,6 +22,11 @@ public:
 	void HandleNetworkEvent(PlayerAction action, CommandQueue& commands);
 	void HandleNetworkRealtimeChange(PlayerAction action, bool action_enabled);
 
+	//Rollback networking samples input once per tick as one bit per PlayerAction, instead of sending every change
+	void RecordEvent(const sf::Event& event);
+	std::uint8_t TakeInput();
+	void ApplyInput(std::uint8_t input, CommandQueue& commands);
+
 	
 	void SetMissionStatus(MissionStatus status);
 	MissionStatus GetMissionStatus() const;
@@ -34,6 +41,9 @@ private:
 	const KeyBinding* m_key_binding;
 	std::map<PlayerAction, Command> m_action_binding;
 	std::map<PlayerAction, bool> m_action_proxies;
+	std::vector<PlayerAction> m_active_actions;
+	//One-shot actions pressed since the last TakeInput
+	std::uint8_t m_recorded_input;
 	MissionStatus m_current_mission_status;
 	int m_identifier;
 	sf::TcpSocket* m_socket;
@@ -1,11 +1,11 @@
 #include "Projectile.hpp"
 
 #include <valarray>
-#include <SFML/Graphics/RenderTarget.hpp>
 
 #include "DataTables.hpp"
-#include "EmitterNode.hpp"
+#include "RenderSnapshot.hpp"
 #include "ResourceHolder.hpp"
+#include "SimMath.hpp"
 #include "Utility.hpp"
 
 namespace
@@ -19,25 +19,25 @@ Projectile::Projectile(ProjectileType type, const TextureHolder& textures)
 , m_sprite(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect)
 {
 	Utility::CentreOrigin(m_sprite);
+}
 
-	// Add particle system for missiles
-	if (IsGuided())
-	{
-		std::unique_ptr<EmitterNode> smoke(new EmitterNode(ParticleType::kSmoke));
-		smoke->setPosition(0.f, GetBoundingRect().height / 2.f);
-		AttachChild(std::move(smoke));
-
-		std::unique_ptr<EmitterNode> propellant(new EmitterNode(ParticleType::kPropellant));
-		propellant->setPosition(0.f, GetBoundingRect().height / 2.f);
-		AttachChild(std::move(propellant));
+void Projectile::Reset(ProjectileType type, const TextureHolder& textures)
+{
+	Entity::Reset(1);
+	m_type = type;
+	m_sprite.setTexture(textures.Get(Table[static_cast<int>(type)].m_texture));
+	m_sprite.setTextureRect(Table[static_cast<int>(type)].m_texture_rect);
+	m_target_direction = sf::Vector2f();
+	Utility::CentreOrigin(m_sprite);
 
-	}
+	// Hand any missile emitters back, EntityFactory attaches fresh ones if needed
+	DisposeChildren();
 }
 
 void Projectile::GuideTowards(sf::Vector2f position)
 {
 	assert(IsGuided());
-	m_target_direction = Utility::UnitVector(position - GetWorldPosition());
+	m_target_direction = SimMath::ToFloat(SimMath::UnitVector(SimMath::ToSim(position) - SimMath::ToSim(GetWorldPosition())));
 }
 
 bool Projectile::IsGuided() const
@@ -45,6 +45,23 @@ bool Projectile::IsGuided() const
 	return m_type == ProjectileType::kMissile;
 }
 
+ProjectileType Projectile::GetType() const
+{
+	return m_type;
+}
+
+void Projectile::SaveState(WorldState& state) const
+{
+	Entity::SaveState(state);
+	state.Write(m_target_direction);
+}
+
+void Projectile::RestoreState(WorldState::Reader& state)
+{
+	Entity::RestoreState(state);
+	m_target_direction = state.Read<sf::Vector2f>();
+}
+
 unsigned int Projectile::GetCategory() const
 {
 	if (m_type == ProjectileType::kEnemyBullet)
@@ -54,6 +71,11 @@ unsigned int Projectile::GetCategory() const
 }
 
 //Axis aligned bounding box
+sf::FloatRect Projectile::GetDrawBounds() const
+{
+	return m_sprite.getGlobalBounds();
+}
+
 sf::FloatRect Projectile::GetBoundingRect() const
 {
 	return GetWorldTransform().transformRect((m_sprite.getGlobalBounds()));
@@ -74,17 +96,17 @@ void Projectile::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 	if(IsGuided())
 	{
 		//Increase approach rate to move in the direction of the target faster
-		const float approach_rate = 200.f;
-		sf::Vector2f new_velocity = Utility::UnitVector(approach_rate * dt.asSeconds() * m_target_direction + GetVelocity());
-		new_velocity *= GetMaxSpeed();
-		float angle = std::atan2(new_velocity.y, new_velocity.x);
-		setRotation(Utility::ToDegrees(angle) + 90.f);
-		SetVelocity(new_velocity);
+		const SimScalar approach_rate(200.f);
+		SimVector new_velocity = SimMath::UnitVector(approach_rate * SimMath::ToSim(dt.asSeconds()) * SimMath::ToSim(m_target_direction) + SimMath::ToSim(GetVelocity()));
+		new_velocity *= SimMath::ToSim(GetMaxSpeed());
+		SimScalar angle = SimMath::Atan2(new_velocity.y, new_velocity.x);
+		setRotation(SimMath::ToFloat(SimMath::ToDegrees(angle)) + 90.f);
+		SetVelocity(SimMath::ToFloat(new_velocity));
 	}
 	Entity::UpdateCurrent(dt, commands);
 }
 
-void Projectile::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void Projectile::DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const
 {
-	target.draw(m_sprite, states);
+	snapshot.Draw(m_sprite, states);
 }
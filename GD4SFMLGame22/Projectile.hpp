@@ -10,17 +10,23 @@ class Projectile : public Entity
 {
 public:
 	Projectile(ProjectileType type, const TextureHolder& textures);
+	void Reset(ProjectileType type, const TextureHolder& textures);
 	void GuideTowards(sf::Vector2f position);
 	bool IsGuided() const;
+	ProjectileType GetType() const;
 
 	unsigned int GetCategory() const override;
 	sf::FloatRect GetBoundingRect() const override;
 	float GetMaxSpeed() const;
 	int GetDamage() const;
 
+	void SaveState(WorldState& state) const override;
+	void RestoreState(WorldState::Reader& state) override;
+
 private:
 	virtual void UpdateCurrent(sf::Time dt, CommandQueue& commands) override;
-	virtual void DrawCurrent(sf::RenderTarget&, sf::RenderStates states) const override;
+	virtual void DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const override;
+	virtual sf::FloatRect GetDrawBounds() const override;
 
 private:
 	ProjectileType m_type;
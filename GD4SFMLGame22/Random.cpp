@@ -0,0 +1,141 @@
+#include "Random.hpp"
+
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace
+{
+	std::uint64_t SplitMix64(std::uint64_t& value)
+	{
+		std::uint64_t z = (value += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	std::uint32_t RotateLeft(std::uint32_t value, int bits)
+	{
+		return (value << bits) | (value >> (32 - bits));
+	}
+
+	std::uint64_t TimeSeed()
+	{
+		return static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+	}
+
+	//Root every thread stream is split from, guarded because threads can ask for their stream at the same time
+	std::mutex ThreadRootMutex;
+	Random ThreadRoot(TimeSeed());
+	//Bumped by SeedThreads so streams created under an old seed are split again on their next use
+	std::atomic<std::uint32_t> ThreadRootGeneration(1);
+}
+
+Random::Random(std::uint64_t seed)
+{
+	Seed(seed);
+}
+
+void Random::Seed(std::uint64_t seed)
+{
+	//SplitMix spreads any seed, including 0, over the whole state so it is never all zero
+	for (std::size_t i = 0; i < m_state.size(); i += 2)
+	{
+		std::uint64_t bits = SplitMix64(seed);
+		m_state[i] = static_cast<std::uint32_t>(bits);
+		m_state[i + 1] = static_cast<std::uint32_t>(bits >> 32);
+	}
+}
+
+std::uint32_t Random::Next()
+{
+	const std::uint32_t result = RotateLeft(m_state[1] * 5, 7) * 9;
+	const std::uint32_t t = m_state[1] << 9;
+
+	m_state[2] ^= m_state[0];
+	m_state[3] ^= m_state[1];
+	m_state[1] ^= m_state[2];
+	m_state[0] ^= m_state[3];
+	m_state[2] ^= t;
+	m_state[3] = RotateLeft(m_state[3], 11);
+
+	return result;
+}
+
+int Random::NextInt(int exclusive_max)
+{
+	assert(exclusive_max > 0);
+	//Scales the draw into range with a multiply instead of %, the bias left is below 2^-32 per value for the small ranges used here
+	const std::uint64_t scaled = static_cast<std::uint64_t>(Next()) * static_cast<std::uint32_t>(exclusive_max);
+	return static_cast<int>(scaled >> 32);
+}
+
+float Random::NextFloat()
+{
+	//Top 24 bits fill the float mantissa exactly, giving [0, 1)
+	return static_cast<float>(Next() >> 8) * (1.f / 16777216.f);
+}
+
+Random Random::Split()
+{
+	const std::uint64_t high = Next();
+	const std::uint64_t low = Next();
+	return Random((high << 32) | low);
+}
+
+void Random::Jump()
+{
+	static const std::uint32_t kJump[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+	State jumped = {};
+	for (std::uint32_t word : kJump)
+	{
+		for (int bit = 0; bit < 32; ++bit)
+		{
+			if (word & (1u << bit))
+			{
+				for (std::size_t i = 0; i < jumped.size(); ++i)
+				{
+					jumped[i] ^= m_state[i];
+				}
+			}
+			Next();
+		}
+	}
+	m_state = jumped;
+}
+
+Random::State Random::GetState() const
+{
+	return m_state;
+}
+
+void Random::SetState(const State& state)
+{
+	//All zero is the one state xoshiro never leaves
+	assert(state[0] != 0 || state[1] != 0 || state[2] != 0 || state[3] != 0);
+	m_state = state;
+}
+
+Random& Random::ForThisThread()
+{
+	thread_local Random stream(0);
+	thread_local std::uint32_t generation = 0;
+
+	//Only the first call on a thread, or the first after a reseed, takes the lock
+	if (generation != ThreadRootGeneration.load(std::memory_order_acquire))
+	{
+		std::lock_guard<std::mutex> lock(ThreadRootMutex);
+		stream = ThreadRoot.Split();
+		generation = ThreadRootGeneration.load(std::memory_order_relaxed);
+	}
+	return stream;
+}
+
+void Random::SeedThreads(std::uint64_t seed)
+{
+	std::lock_guard<std::mutex> lock(ThreadRootMutex);
+	ThreadRoot.Seed(seed);
+	ThreadRootGeneration.fetch_add(1, std::memory_order_release);
+}
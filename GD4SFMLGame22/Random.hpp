@@ -0,0 +1,35 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+//Deterministic xoshiro128** generator, the same seed gives the same numbers on every platform and compiler
+//Each owner keeps its own stream: the World rolls its dice on one, the server on another and every thread on its own
+//State is four plain words so a stream can be saved with the simulation and restored to replay the same rolls
+class Random
+{
+public:
+	typedef std::array<std::uint32_t, 4> State;
+
+public:
+	explicit Random(std::uint64_t seed);
+
+	void Seed(std::uint64_t seed);
+	std::uint32_t Next();
+	int NextInt(int exclusive_max);
+	float NextFloat();
+
+	//Derives an independent stream from this one, the parent advances so repeated splits give different children
+	Random Split();
+	//Advances by 2^64 draws, streams jumped apart from one seed never overlap
+	void Jump();
+
+	State GetState() const;
+	void SetState(const State& state);
+
+	//Stream of the calling thread, split from a shared root the first time a thread asks for it
+	static Random& ForThisThread();
+	static void SeedThreads(std::uint64_t seed);
+
+private:
+	State m_state;
+};
@@ -0,0 +1,532 @@
+#include "RenderSnapshot.hpp"
+
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shape.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+#include "CachedLayer.hpp"
+#include "StaticGeometry.hpp"
+#include "VertexStream.hpp"
+
+//The text layout below copies sf::Text's: the italic shear, the glyph padding and how letter spacing scales
+static_assert(SFML_VERSION_MAJOR == 2 && SFML_VERSION_MINOR == 5, "Check RenderSnapshot's text layout against sf::Text of this SFML version");
+
+namespace
+{
+	//Only printable ASCII is loaded ahead, anything else would have to be added to the atlas while it is in use
+	const sf::Uint32 kFirstPreloadedCharacter = 32;
+	const sf::Uint32 kLastPreloadedCharacter = 126;
+
+	struct PreloadedGlyphs
+	{
+		const sf::Font* m_font;
+		unsigned int m_character_size;
+		bool m_bold;
+	};
+
+	//Filled before the RenderThread starts and only read after that
+	std::vector<PreloadedGlyphs> PreloadedFonts;
+
+	bool HasPreloadedGlyphs(const sf::Font& font, unsigned int character_size, bool bold)
+	{
+		return std::any_of(PreloadedFonts.begin(), PreloadedFonts.end(), [&](const PreloadedGlyphs& preloaded)
+		{
+			return preloaded.m_font == &font && preloaded.m_character_size == character_size && preloaded.m_bold == bold;
+		});
+	}
+}
+
+const std::size_t RenderSnapshot::kVerticesPerSprite;
+
+RenderSnapshot::RenderSnapshot()
+	: m_bucket_count(0)
+	, m_batching(false)
+	, m_sprite_count(0)
+	, m_glyph_count(0)
+{
+}
+
+void RenderSnapshot::Clear(const sf::View& default_view, sf::Color clear_colour)
+{
+	m_default_view = default_view;
+	m_clear_colour = clear_colour;
+	m_items.clear();
+	m_views.clear();
+	m_vertices.clear();
+	m_bucket_count = 0;
+	m_batching = false;
+	m_sprite_count = 0;
+	m_glyph_count = 0;
+	m_sample = FrameSample();
+}
+
+const sf::View& RenderSnapshot::GetDefaultView() const
+{
+	return m_default_view;
+}
+
+void RenderSnapshot::SetView(const sf::View& view)
+{
+	Item& item = AddItem(ItemType::kView, sf::RenderStates::Default);
+	item.m_first = m_views.size();
+	m_views.emplace_back(view);
+}
+
+void RenderSnapshot::Draw(const sf::Sprite& sprite, const sf::RenderStates& states)
+{
+	if (sprite.getTexture() == nullptr)
+	{
+		return;
+	}
+
+	sf::Vertex quad[kVerticesPerSprite];
+	GetSpriteQuad(sprite, states.transform, quad);
+	std::vector<sf::Vertex>& vertices = GetSpriteVertices(*sprite.getTexture(), states.blendMode);
+	vertices.insert(vertices.end(), quad, quad + kVerticesPerSprite);
+	++m_sprite_count;
+	if (!m_batching)
+	{
+		m_items.back().m_count += kVerticesPerSprite;
+	}
+}
+
+//Lays the glyphs out the way sf::Text does and records them as sprite quads on the font's atlas texture
+//Only the geometry is recorded, the render thread never touches the font. Outlines, underlines and
+//strike throughs are not drawn, nothing in the game uses them
+void RenderSnapshot::Draw(const sf::Text& text, const sf::RenderStates& states)
+{
+	const sf::Font* font = text.getFont();
+	const sf::String& string = text.getString();
+	if (font == nullptr || string.isEmpty())
+	{
+		return;
+	}
+
+	const sf::Uint32 style = text.getStyle();
+	const unsigned int size = text.getCharacterSize();
+	const bool bold = (style & sf::Text::Bold) != 0;
+	if (!HasPreloadedGlyphs(*font, size, bold))
+	{
+		assert(!"Text drawn with a font and size whose glyphs were not preloaded");
+		return;
+	}
+	const float italic_shear = (style & sf::Text::Italic) != 0 ? 0.209f : 0.f;
+	const float whitespace = font->getGlyph(L' ', size, bold).advance;
+	const float letter_spacing = (whitespace / 3.f) * (text.getLetterSpacing() - 1.f);
+	const float whitespace_width = whitespace + letter_spacing;
+	const float line_spacing = font->getLineSpacing(size) * text.getLineSpacing();
+	const sf::Transform transform = states.transform * text.getTransform();
+	const sf::Color colour = text.getFillColor();
+
+	//The glyphs were all loaded by PreloadGlyphs, getting them now only looks them up and leaves the atlas
+	//the render thread draws from alone
+	const sf::Texture& atlas = font->getTexture(size);
+	if (m_batching && HoldsOtherBuckets(atlas, states.blendMode))
+	{
+		//Sprites drawn after the text have to stay on top of it, so they must not join the buckets from before it
+		EndSpriteBatch();
+		BeginSpriteBatch();
+	}
+	std::vector<sf::Vertex>& vertices = GetSpriteVertices(atlas, states.blendMode);
+	const std::size_t first = vertices.size();
+	float x = 0.f;
+	float y = static_cast<float>(size);
+	sf::Uint32 previous = 0;
+	for (std::size_t i = 0; i < string.getSize(); ++i)
+	{
+		const sf::Uint32 current = string[i];
+		if (current == '\r')
+		{
+			continue;
+		}
+
+		x += font->getKerning(previous, current, size);
+		previous = current;
+
+		switch (current)
+		{
+		case ' ':
+			x += whitespace_width;
+			continue;
+		case '\t':
+			x += whitespace_width * 4.f;
+			continue;
+		case '\n':
+			y += line_spacing;
+			x = 0.f;
+			continue;
+		}
+
+		if (current < kFirstPreloadedCharacter || current > kLastPreloadedCharacter)
+		{
+			continue;
+		}
+
+		//The same padded quad sf::Text builds, so filtering does not cut the glyph's edges
+		const sf::Glyph& glyph = font->getGlyph(current, size, bold);
+		const float padding = 1.f;
+		const float left = glyph.bounds.left - padding;
+		const float top = glyph.bounds.top - padding;
+		const float right = glyph.bounds.left + glyph.bounds.width + padding;
+		const float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+		const float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+		const float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+		const float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+		const float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+		const sf::Vertex top_left(transform.transformPoint(x + left - italic_shear * top, y + top), colour, sf::Vector2f(u1, v1));
+		const sf::Vertex top_right(transform.transformPoint(x + right - italic_shear * top, y + top), colour, sf::Vector2f(u2, v1));
+		const sf::Vertex bottom_left(transform.transformPoint(x + left - italic_shear * bottom, y + bottom), colour, sf::Vector2f(u1, v2));
+		const sf::Vertex bottom_right(transform.transformPoint(x + right - italic_shear * bottom, y + bottom), colour, sf::Vector2f(u2, v2));
+		vertices.push_back(top_left);
+		vertices.push_back(bottom_left);
+		vertices.push_back(top_right);
+		vertices.push_back(top_right);
+		vertices.push_back(bottom_left);
+		vertices.push_back(bottom_right);
+		++m_glyph_count;
+
+		x += glyph.advance + letter_spacing;
+	}
+
+	if (!m_batching)
+	{
+		m_items.back().m_count += vertices.size() - first;
+	}
+}
+
+void RenderSnapshot::PreloadGlyphs(const sf::Font& font, unsigned int character_size, bool bold)
+{
+	for (sf::Uint32 character = kFirstPreloadedCharacter; character <= kLastPreloadedCharacter; ++character)
+	{
+		font.getGlyph(character, character_size, bold);
+	}
+	if (!HasPreloadedGlyphs(font, character_size, bold))
+	{
+		PreloadedGlyphs preloaded = { &font, character_size, bold };
+		PreloadedFonts.emplace_back(preloaded);
+	}
+}
+
+void RenderSnapshot::Draw(const sf::VertexArray& vertices, const sf::RenderStates& states)
+{
+	if (vertices.getVertexCount() > 0)
+	{
+		Draw(&vertices[0], vertices.getVertexCount(), vertices.getPrimitiveType(), states);
+	}
+}
+
+void RenderSnapshot::Draw(const sf::Vertex* vertices, std::size_t vertex_count, sf::PrimitiveType type, const sf::RenderStates& states)
+{
+	Item& item = AddItem(ItemType::kVertices, states);
+	item.m_texture = states.texture;
+	item.m_primitive = type;
+	item.m_first = m_vertices.size();
+	item.m_count = vertex_count;
+	m_vertices.insert(m_vertices.end(), vertices, vertices + vertex_count);
+}
+
+//Shapes are recorded untextured, as a fan for the fill and a closed line strip for the outline
+//Only convex shapes such as sf::RectangleShape fill correctly this way
+void RenderSnapshot::Draw(const sf::Shape& shape, const sf::RenderStates& states)
+{
+	const std::size_t point_count = shape.getPointCount();
+	if (point_count < 3)
+	{
+		return;
+	}
+
+	sf::RenderStates shape_states = states;
+	shape_states.transform *= shape.getTransform();
+
+	if (shape.getFillColor().a > 0)
+	{
+		Item& item = AddItem(ItemType::kVertices, shape_states);
+		item.m_primitive = sf::TriangleFan;
+		item.m_first = m_vertices.size();
+		item.m_count = point_count;
+		for (std::size_t i = 0; i < point_count; ++i)
+		{
+			m_vertices.emplace_back(shape.getPoint(i), shape.getFillColor());
+		}
+	}
+
+	if (shape.getOutlineThickness() != 0.f && shape.getOutlineColor().a > 0)
+	{
+		Item& item = AddItem(ItemType::kVertices, shape_states);
+		item.m_primitive = sf::LineStrip;
+		item.m_first = m_vertices.size();
+		item.m_count = point_count + 1;
+		for (std::size_t i = 0; i <= point_count; ++i)
+		{
+			m_vertices.emplace_back(shape.getPoint(i % point_count), shape.getOutlineColor());
+		}
+	}
+}
+
+void RenderSnapshot::Draw(const StaticGeometry& geometry, const sf::RenderStates& states)
+{
+	Item& item = AddItem(ItemType::kStatic, states);
+	item.m_texture = states.texture;
+	item.m_geometry = &geometry;
+}
+
+void RenderSnapshot::Draw(const CachedLayer& layer, const sf::RenderStates& states)
+{
+	Item& item = AddItem(ItemType::kCachedLayer, states);
+	item.m_layer = &layer;
+}
+
+void RenderSnapshot::BeginSpriteBatch()
+{
+	assert(!m_batching);
+	m_batching = true;
+	m_bucket_count = 0;
+}
+
+void RenderSnapshot::EndSpriteBatch()
+{
+	assert(m_batching);
+	m_batching = false;
+	for (std::size_t i = 0; i < m_bucket_count; ++i)
+	{
+		SpriteBucket& bucket = m_buckets[i];
+		Item& item = m_items[bucket.m_item];
+		item.m_first = m_vertices.size();
+		item.m_count = bucket.m_vertices.size();
+		m_vertices.insert(m_vertices.end(), bucket.m_vertices.begin(), bucket.m_vertices.end());
+	}
+	m_bucket_count = 0;
+}
+
+std::size_t RenderSnapshot::GetDrawCallCount() const
+{
+	return m_items.size() - m_views.size();
+}
+
+std::size_t RenderSnapshot::GetSpriteCount() const
+{
+	return m_sprite_count;
+}
+
+std::size_t RenderSnapshot::GetGlyphCount() const
+{
+	return m_glyph_count;
+}
+
+sf::FloatRect RenderSnapshot::GetVertexBounds() const
+{
+	//Vertices still in an open batch's buckets are not in m_vertices yet
+	assert(!m_batching);
+	if (m_vertices.empty())
+	{
+		return sf::FloatRect();
+	}
+
+	sf::Vector2f min = m_vertices.front().position;
+	sf::Vector2f max = min;
+	for (const sf::Vertex& vertex : m_vertices)
+	{
+		min.x = std::min(min.x, vertex.position.x);
+		min.y = std::min(min.y, vertex.position.y);
+		max.x = std::max(max.x, vertex.position.x);
+		max.y = std::max(max.y, vertex.position.y);
+	}
+	return sf::FloatRect(min, max - min);
+}
+
+FrameSample& RenderSnapshot::GetSample()
+{
+	return m_sample;
+}
+
+const FrameSample& RenderSnapshot::GetSample() const
+{
+	return m_sample;
+}
+
+void RenderSnapshot::GetSpriteQuad(const sf::Sprite& sprite, const sf::Transform& transform, sf::Vertex* quad)
+{
+	//The same corners and texture coordinates sf::Sprite builds, a flipped texture rect has a negative size
+	const sf::IntRect rect = sprite.getTextureRect();
+	const sf::Vector2f size(static_cast<float>(std::abs(rect.width)), static_cast<float>(std::abs(rect.height)));
+	const float left = static_cast<float>(rect.left);
+	const float right = left + rect.width;
+	const float top = static_cast<float>(rect.top);
+	const float bottom = top + rect.height;
+
+	const sf::Transform combined = transform * sprite.getTransform();
+	const sf::Color colour = sprite.getColor();
+	const sf::Vertex top_left(combined.transformPoint(0.f, 0.f), colour, sf::Vector2f(left, top));
+	const sf::Vertex bottom_left(combined.transformPoint(0.f, size.y), colour, sf::Vector2f(left, bottom));
+	const sf::Vertex top_right(combined.transformPoint(size.x, 0.f), colour, sf::Vector2f(right, top));
+	const sf::Vertex bottom_right(combined.transformPoint(size.x, size.y), colour, sf::Vector2f(right, bottom));
+
+	quad[0] = top_left;
+	quad[1] = bottom_left;
+	quad[2] = top_right;
+	quad[3] = top_right;
+	quad[4] = bottom_left;
+	quad[5] = bottom_right;
+}
+
+void RenderSnapshot::Replay(sf::RenderTarget& target, VertexStream* stream, RenderCounters* counters) const
+{
+	target.clear(m_clear_colour);
+	Overlay(target, stream, counters);
+}
+
+void RenderSnapshot::Overlay(sf::RenderTarget& target, VertexStream* stream, RenderCounters* counters) const
+{
+	target.setView(m_default_view);
+
+	//What the previous draw used, a draw that uses something else makes the target bind or set it again
+	const void* last_texture = nullptr;
+	sf::BlendMode last_blend_mode = sf::BlendAlpha;
+	sf::Transform last_transform;
+	auto count = [&](const Item& item, const void* texture, std::size_t vertex_count)
+	{
+		if (!counters)
+		{
+			return;
+		}
+		++counters->m_draw_calls;
+		counters->m_vertices += vertex_count;
+		if (texture != last_texture)
+		{
+			++counters->m_texture_binds;
+			last_texture = texture;
+		}
+		if (item.m_blend_mode != last_blend_mode)
+		{
+			++counters->m_state_changes;
+			last_blend_mode = item.m_blend_mode;
+		}
+		if (!std::equal(last_transform.getMatrix(), last_transform.getMatrix() + 16, item.m_transform.getMatrix()))
+		{
+			++counters->m_state_changes;
+			last_transform = item.m_transform;
+		}
+	};
+
+	for (const Item& item : m_items)
+	{
+		sf::RenderStates states(item.m_blend_mode);
+		states.transform = item.m_transform;
+
+		switch (item.m_type)
+		{
+		case ItemType::kView:
+			target.setView(m_views[item.m_first]);
+			if (counters)
+			{
+				++counters->m_state_changes;
+			}
+			break;
+		case ItemType::kVertices:
+			count(item, item.m_texture, item.m_count);
+			states.texture = item.m_texture;
+			if (stream)
+			{
+				stream->Draw(target, &m_vertices[item.m_first], item.m_count, item.m_primitive, states);
+			}
+			else
+			{
+				target.draw(&m_vertices[item.m_first], item.m_count, item.m_primitive, states);
+			}
+			break;
+		case ItemType::kStatic:
+			count(item, item.m_texture, item.m_geometry->GetVertexCount());
+			states.texture = item.m_texture;
+			item.m_geometry->Draw(target, states);
+			break;
+		case ItemType::kCachedLayer:
+			//One quad textured with the layer's render texture, the layer stands in for the texture
+			count(item, item.m_layer, 4);
+			item.m_layer->Draw(target, states);
+			break;
+		}
+	}
+}
+
+RenderSnapshot::Item& RenderSnapshot::AddItem(ItemType type, const sf::RenderStates& states)
+{
+	//Shaders cannot be recorded, nothing in the game draws with one outside the disabled bloom effect
+	assert(states.shader == nullptr);
+
+	Item item;
+	item.m_type = type;
+	item.m_transform = states.transform;
+	item.m_blend_mode = states.blendMode;
+	item.m_texture = nullptr;
+	item.m_primitive = sf::Points;
+	item.m_sprites = false;
+	item.m_geometry = nullptr;
+	item.m_layer = nullptr;
+	item.m_first = 0;
+	item.m_count = 0;
+	m_items.emplace_back(item);
+	return m_items.back();
+}
+
+bool RenderSnapshot::HoldsOtherBuckets(const sf::Texture& texture, const sf::BlendMode& blend_mode) const
+{
+	for (std::size_t i = 0; i < m_bucket_count; ++i)
+	{
+		if (m_buckets[i].m_texture != &texture || m_buckets[i].m_blend_mode != blend_mode)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<sf::Vertex>& RenderSnapshot::GetSpriteVertices(const sf::Texture& texture, const sf::BlendMode& blend_mode)
+{
+	if (!m_batching)
+	{
+		//Join the previous item if it is a run of sprites with the same texture, otherwise start a new run
+		const bool joins = !m_items.empty() && m_items.back().m_sprites && m_items.back().m_texture == &texture
+			&& m_items.back().m_blend_mode == blend_mode && m_items.back().m_first + m_items.back().m_count == m_vertices.size();
+		if (!joins)
+		{
+			Item& item = AddItem(ItemType::kVertices, sf::RenderStates(blend_mode));
+			item.m_texture = &texture;
+			item.m_primitive = sf::Triangles;
+			item.m_sprites = true;
+			item.m_first = m_vertices.size();
+		}
+		return m_vertices;
+	}
+
+	for (std::size_t i = 0; i < m_bucket_count; ++i)
+	{
+		if (m_buckets[i].m_texture == &texture && m_buckets[i].m_blend_mode == blend_mode)
+		{
+			return m_buckets[i].m_vertices;
+		}
+	}
+
+	//First sprite with this texture in the batch, its item holds the place the whole bucket is drawn at
+	if (m_bucket_count == m_buckets.size())
+	{
+		m_buckets.emplace_back();
+	}
+	SpriteBucket& bucket = m_buckets[m_bucket_count++];
+	bucket.m_texture = &texture;
+	bucket.m_blend_mode = blend_mode;
+	bucket.m_item = m_items.size();
+	bucket.m_vertices.clear();
+	Item& item = AddItem(ItemType::kVertices, sf::RenderStates(blend_mode));
+	item.m_texture = &texture;
+	item.m_primitive = sf::Triangles;
+	item.m_sprites = true;
+	return bucket.m_vertices;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <SFML/Graphics/BlendMode.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/View.hpp>
+
+#include <vector>
+
+#include "FrameSample.hpp"
+
+namespace sf
+{
+	class RenderTarget;
+	class Shape;
+	class Sprite;
+	class Texture;
+	class VertexArray;
+}
+
+class CachedLayer;
+class StaticGeometry;
+class VertexStream;
+
+//Everything needed to draw one frame, recorded on the simulation thread and replayed by the RenderThread
+//Draw copies what it is given, so the scene can carry on updating while the frame is being put on screen
+//The containers keep their capacity between frames, recording a frame allocates nothing once they have grown
+//Sprites are recorded as transformed quads, so sprites sharing a texture are drawn together in one call:
+//back to back sprites always join up, and between BeginSpriteBatch and EndSpriteBatch every sprite joins the others
+//with its texture wherever it was drawn, in one call per texture placed where the first of them was drawn
+//Plain text is recorded the same way, one quad per glyph textured from the font's atlas for its character size,
+//so labels using the same font and size are drawn in a single call. Text keeps its place among the sprites:
+//a batch is closed before a text and a new one opened, unless it only holds text on that same atlas
+class RenderSnapshot
+{
+public:
+	//Two triangles per quad, so batches of separate sprites draw as one sf::Triangles array
+	static const std::size_t kVerticesPerSprite = 6;
+
+public:
+	RenderSnapshot();
+
+	void Clear(const sf::View& default_view, sf::Color clear_colour = sf::Color::Black);
+	const sf::View& GetDefaultView() const;
+
+	void SetView(const sf::View& view);
+	void Draw(const sf::Sprite& sprite, const sf::RenderStates& states = sf::RenderStates::Default);
+	void Draw(const sf::Text& text, const sf::RenderStates& states = sf::RenderStates::Default);
+	void Draw(const sf::VertexArray& vertices, const sf::RenderStates& states = sf::RenderStates::Default);
+	void Draw(const sf::Vertex* vertices, std::size_t vertex_count, sf::PrimitiveType type, const sf::RenderStates& states = sf::RenderStates::Default);
+	void Draw(const sf::Shape& shape, const sf::RenderStates& states = sf::RenderStates::Default);
+	//Only the reference is recorded, the geometry must outlive the frame
+	void Draw(const StaticGeometry& geometry, const sf::RenderStates& states = sf::RenderStates::Default);
+	void Draw(const CachedLayer& layer, const sf::RenderStates& states = sf::RenderStates::Default);
+
+	void BeginSpriteBatch();
+	void EndSpriteBatch();
+
+	//Vertices recorded this frame go through stream when there is one, otherwise they are drawn from client memory
+	//SFML's draw calls cannot be hooked, so what the replay asks of the target is tallied here into counters when given
+	void Replay(sf::RenderTarget& target, VertexStream* stream = nullptr, RenderCounters* counters = nullptr) const;
+	//Replay without clearing, the frame is drawn over what the target already shows
+	void Overlay(sf::RenderTarget& target, VertexStream* stream = nullptr, RenderCounters* counters = nullptr) const;
+
+	//Timings of the frame, carried along to the RenderThread with it
+	FrameSample& GetSample();
+	const FrameSample& GetSample() const;
+
+	//Draw calls Replay will make, and how many sprites and glyphs went into them
+	std::size_t GetDrawCallCount() const;
+	std::size_t GetSpriteCount() const;
+	std::size_t GetGlyphCount() const;
+	//Smallest rectangle around every vertex recorded so far, for checking recorded geometry against SFML's own
+	sf::FloatRect GetVertexBounds() const;
+
+	//Loads the printable ASCII glyphs of font at character_size into its atlas. Text can only be drawn at sizes
+	//loaded this way, and all of them must be loaded before the RenderThread starts: a glyph loaded later would
+	//change the atlas while the render thread draws from it. Other characters are left out of the text
+	static void PreloadGlyphs(const sf::Font& font, unsigned int character_size, bool bold = false);
+
+	//Writes the kVerticesPerSprite vertices of the sprite's quad, placed by transform and the sprite's own transform
+	static void GetSpriteQuad(const sf::Sprite& sprite, const sf::Transform& transform, sf::Vertex* quad);
+
+private:
+	enum class ItemType
+	{
+		kView,
+		kVertices,
+		kStatic,
+		kCachedLayer
+	};
+
+	struct Item
+	{
+		ItemType m_type;
+		sf::Transform m_transform;
+		sf::BlendMode m_blend_mode;
+		const sf::Texture* m_texture;
+		sf::PrimitiveType m_primitive;
+		//Pre-transformed sprite quads that later sprites with the same texture can join
+		bool m_sprites;
+		const StaticGeometry* m_geometry;
+		const CachedLayer* m_layer;
+		//Range in m_views or m_vertices depending on the type
+		std::size_t m_first;
+		std::size_t m_count;
+	};
+
+	//Sprites of one texture and blend mode collected while a batch is open, written out to their item by EndSpriteBatch
+	struct SpriteBucket
+	{
+		const sf::Texture* m_texture;
+		sf::BlendMode m_blend_mode;
+		std::size_t m_item;
+		std::vector<sf::Vertex> m_vertices;
+	};
+
+	Item& AddItem(ItemType type, const sf::RenderStates& states);
+	std::vector<sf::Vertex>& GetSpriteVertices(const sf::Texture& texture, const sf::BlendMode& blend_mode);
+	//Whether the open batch has collected anything not drawn with this texture and blend mode
+	bool HoldsOtherBuckets(const sf::Texture& texture, const sf::BlendMode& blend_mode) const;
+
+private:
+	sf::View m_default_view;
+	sf::Color m_clear_colour;
+	std::vector<Item> m_items;
+	std::vector<sf::View> m_views;
+	std::vector<sf::Vertex> m_vertices;
+	std::vector<SpriteBucket> m_buckets;
+	std::size_t m_bucket_count;
+	bool m_batching;
+	std::size_t m_sprite_count;
+	std::size_t m_glyph_count;
+	FrameSample m_sample;
+};
@@ -0,0 +1,149 @@
+#include "RenderStatistics.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+	std::string FormatTimes(const char* phase, const TimingWindow& window)
+	{
+		//Milliseconds to two places reads better on the overlay than whole microseconds
+		char line[96];
+		std::snprintf(line, sizeof(line), "%s = %.2f / %.2f / %.2f ms", phase, window.GetMin().asSeconds() * 1000.f,
+			window.GetAverage().asSeconds() * 1000.f, window.GetPercentile(0.99f).asSeconds() * 1000.f);
+		return line;
+	}
+}
+
+const std::size_t RenderStatistics::kDefaultWindowSize;
+
+TimingWindow::TimingWindow(std::size_t capacity)
+	: m_samples(capacity, 0)
+	, m_next(0)
+	, m_count(0)
+	, m_sorted(capacity, 0)
+{
+	assert(capacity > 0);
+}
+
+void TimingWindow::Add(sf::Time sample)
+{
+	m_samples[m_next] = sample.asMicroseconds();
+	m_next = (m_next + 1) % m_samples.size();
+	m_count = std::min(m_count + 1, m_samples.size());
+}
+
+std::size_t TimingWindow::GetSize() const
+{
+	return m_count;
+}
+
+sf::Time TimingWindow::GetMin() const
+{
+	if (m_count == 0)
+	{
+		return sf::Time::Zero;
+	}
+	return sf::microseconds(*std::min_element(m_samples.begin(), m_samples.begin() + m_count));
+}
+
+sf::Time TimingWindow::GetAverage() const
+{
+	if (m_count == 0)
+	{
+		return sf::Time::Zero;
+	}
+	sf::Int64 total = 0;
+	for (std::size_t i = 0; i < m_count; ++i)
+	{
+		total += m_samples[i];
+	}
+	return sf::microseconds(total / static_cast<sf::Int64>(m_count));
+}
+
+sf::Time TimingWindow::GetPercentile(float fraction) const
+{
+	if (m_count == 0)
+	{
+		return sf::Time::Zero;
+	}
+	//0.99f is a hair over 0.99, without the allowance 99% of 100 samples would round up to the largest
+	const std::size_t rank = static_cast<std::size_t>(std::ceil(static_cast<double>(fraction) * m_count - 1e-3));
+	const std::size_t index = std::min(std::max<std::size_t>(rank, 1), m_count) - 1;
+	std::copy(m_samples.begin(), m_samples.begin() + m_count, m_sorted.begin());
+	std::nth_element(m_sorted.begin(), m_sorted.begin() + index, m_sorted.begin() + m_count);
+	return sf::microseconds(m_sorted[index]);
+}
+
+RenderStatistics::RenderStatistics(std::size_t window_size)
+	: m_update(window_size)
+	, m_record(window_size)
+	, m_replay(window_size)
+	, m_display(window_size)
+	, m_counter_totals()
+	, m_counted_frames(0)
+	, m_dropped_frames(0)
+	, m_frame_number(0)
+{
+}
+
+void RenderStatistics::AddFrame(const FrameSample& sample)
+{
+	m_update.Add(sample.m_update);
+	m_record.Add(sample.m_record);
+	m_replay.Add(sample.m_replay);
+	m_display.Add(sample.m_display);
+
+	m_counter_totals.m_draw_calls += sample.m_counters.m_draw_calls;
+	m_counter_totals.m_vertices += sample.m_counters.m_vertices;
+	m_counter_totals.m_texture_binds += sample.m_counters.m_texture_binds;
+	m_counter_totals.m_state_changes += sample.m_counters.m_state_changes;
+	m_dropped_frames += sample.m_dropped_frames;
+	++m_counted_frames;
+	++m_frame_number;
+
+	if (m_csv.is_open())
+	{
+		m_csv << m_frame_number << ','
+			<< sample.m_update.asMicroseconds() << ',' << sample.m_record.asMicroseconds() << ','
+			<< sample.m_replay.asMicroseconds() << ',' << sample.m_display.asMicroseconds() << ','
+			<< sample.m_counters.m_draw_calls << ',' << sample.m_counters.m_vertices << ','
+			<< sample.m_counters.m_texture_binds << ',' << sample.m_counters.m_state_changes << ','
+			<< sample.m_dropped_frames << '\n';
+	}
+}
+
+bool RenderStatistics::OpenCsv(const std::string& filename)
+{
+	m_csv.open(filename, std::ios::out | std::ios::trunc);
+	if (!m_csv)
+	{
+		return false;
+	}
+	m_csv << "frame,update_us,record_us,replay_us,display_us,draw_calls,vertices,texture_binds,state_changes,dropped_frames\n";
+	return true;
+}
+
+std::string RenderStatistics::GetSummary() const
+{
+	const std::size_t frames = std::max<std::size_t>(m_counted_frames, 1);
+	return "Draw Calls / Frame = " + std::to_string(m_counter_totals.m_draw_calls / frames) +
+		" (" + std::to_string(m_counter_totals.m_vertices / frames) + " vertices)\n" +
+		"Texture Binds / Frame = " + std::to_string(m_counter_totals.m_texture_binds / frames) +
+		", State Changes / Frame = " + std::to_string(m_counter_totals.m_state_changes / frames) + "\n" +
+		"Dropped Frames / Second = " + std::to_string(m_dropped_frames) + "\n" +
+		"CPU min / avg / p99 over " + std::to_string(m_update.GetSize()) + " frames\n" +
+		FormatTimes("Update", m_update) + "\n" +
+		FormatTimes("Record", m_record) + "\n" +
+		FormatTimes("Replay", m_replay) + "\n" +
+		FormatTimes("Display", m_display);
+}
+
+void RenderStatistics::ResetCounters()
+{
+	m_counter_totals = RenderCounters();
+	m_counted_frames = 0;
+	m_dropped_frames = 0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "FrameSample.hpp"
+
+//The last few hundred timings of one phase, for its min, average and 99th percentile
+class TimingWindow
+{
+public:
+	explicit TimingWindow(std::size_t capacity);
+
+	void Add(sf::Time sample);
+	std::size_t GetSize() const;
+
+	sf::Time GetMin() const;
+	sf::Time GetAverage() const;
+	//Nearest rank, so 0.99 of 100 samples is the second largest
+	sf::Time GetPercentile(float fraction) const;
+
+private:
+	std::vector<sf::Int64> m_samples;
+	std::size_t m_next;
+	std::size_t m_count;
+	//Scratch for the percentile, sized once so reading the window never allocates
+	mutable std::vector<sf::Int64> m_sorted;
+};
+
+//Gathers the FrameSamples the RenderThread hands back into rolling timing windows and per frame averages of the counters
+//With a CSV file open every frame is also written out as a row, for comparing runs offline
+class RenderStatistics : private sf::NonCopyable
+{
+public:
+	explicit RenderStatistics(std::size_t window_size = kDefaultWindowSize);
+
+	void AddFrame(const FrameSample& sample);
+	bool OpenCsv(const std::string& filename);
+
+	//Counters averaged over the frames since the last ResetCounters, timings over the whole window,
+	//dropped frames counted since the last ResetCounters
+	std::string GetSummary() const;
+	void ResetCounters();
+
+private:
+	static const std::size_t kDefaultWindowSize = 300;
+
+private:
+	TimingWindow m_update;
+	TimingWindow m_record;
+	TimingWindow m_replay;
+	TimingWindow m_display;
+	RenderCounters m_counter_totals;
+	std::size_t m_counted_frames;
+	std::size_t m_dropped_frames;
+	std::ofstream m_csv;
+	std::size_t m_frame_number;
+};
@@ -0,0 +1,155 @@
+#include "RenderThread.hpp"
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+
+namespace
+{
+	//How long the render thread waits before checking again when no new frame has been published
+	const sf::Time kIdleTime = sf::microseconds(500);
+	//Sized for a 100k particle system, 600k vertices in one draw, with the rest of the frame alongside it
+	//A draw bigger than the stream would go back to client memory, 1M vertices (20MB) keeps even that one streamed
+	const std::size_t kVertexStreamCapacity = 1 << 20;
+	//Samples kept for CollectSamples, older ones are dropped if nobody collects them
+	const std::size_t kMaxPendingSamples = 256;
+}
+
+RenderThread::RenderThread(sf::RenderWindow& window)
+	: m_window(window)
+	, m_thread(&RenderThread::ExecutionThread, this)
+	, m_running(false)
+	, m_vertex_stream(kVertexStreamCapacity)
+{
+	m_samples.reserve(kMaxPendingSamples);
+}
+
+RenderThread::~RenderThread()
+{
+	Stop();
+}
+
+void RenderThread::Launch()
+{
+	if (m_running)
+	{
+		return;
+	}
+
+	//A context can only be active on one thread at a time
+	m_window.setActive(false);
+	m_running = true;
+	m_thread.launch();
+}
+
+void RenderThread::Stop()
+{
+	if (!m_running)
+	{
+		return;
+	}
+
+	m_running = false;
+	m_thread.wait();
+	m_window.setActive(true);
+}
+
+bool RenderThread::IsRunning() const
+{
+	return m_running;
+}
+
+RenderSnapshot& RenderThread::BeginFrame()
+{
+	//The window is not resizable, so its default view never changes under the render thread
+	RenderSnapshot& snapshot = m_snapshots.GetBack();
+	snapshot.Clear(m_window.getDefaultView());
+	FrameSample& sample = snapshot.GetSample();
+	sample.m_update = m_dropped.m_update;
+	sample.m_record = m_dropped.m_record;
+	sample.m_dropped_frames = m_dropped.m_dropped_frames;
+	m_dropped = FrameSample();
+	return snapshot;
+}
+
+void RenderThread::Publish()
+{
+	if (m_snapshots.Publish())
+	{
+		//The render thread skipped the frame that comes back, it is cleared by the next BeginFrame
+		Drop(m_snapshots.GetBack().GetSample());
+	}
+	if (!m_running && m_snapshots.Acquire())
+	{
+		Present(m_snapshots.GetFront());
+	}
+}
+
+void RenderThread::Flush()
+{
+	//Without the thread every frame is presented during Publish, nothing is left in flight
+	if (!m_running)
+	{
+		return;
+	}
+
+	//With the lock held this thread can stand in as the consumer and retire the waiting frame,
+	//the front buffer is only ever drawn straight after it is acquired so it is never looked at again
+	std::lock_guard<std::mutex> lock(m_present_mutex);
+	if (m_snapshots.Acquire())
+	{
+		Drop(m_snapshots.GetFront().GetSample());
+	}
+}
+
+void RenderThread::CollectSamples(std::vector<FrameSample>& samples)
+{
+	std::lock_guard<std::mutex> lock(m_samples_mutex);
+	samples.insert(samples.end(), m_samples.begin(), m_samples.end());
+	m_samples.clear();
+}
+
+void RenderThread::Drop(const FrameSample& sample)
+{
+	m_dropped.m_update += sample.m_update;
+	m_dropped.m_record += sample.m_record;
+	m_dropped.m_dropped_frames += sample.m_dropped_frames + 1;
+}
+
+void RenderThread::ExecutionThread()
+{
+	m_window.setActive(true);
+	while (m_running)
+	{
+		bool presented = false;
+		{
+			std::lock_guard<std::mutex> lock(m_present_mutex);
+			if (m_snapshots.Acquire())
+			{
+				Present(m_snapshots.GetFront());
+				presented = true;
+			}
+		}
+		if (!presented)
+		{
+			sf::sleep(kIdleTime);
+		}
+	}
+	m_window.setActive(false);
+}
+
+void RenderThread::Present(const RenderSnapshot& snapshot)
+{
+	FrameSample sample = snapshot.GetSample();
+	sf::Clock clock;
+	snapshot.Replay(m_window, &m_vertex_stream, &sample.m_counters);
+	sample.m_replay = clock.restart();
+	m_window.display();
+	sample.m_display = clock.getElapsedTime();
+
+	std::lock_guard<std::mutex> lock(m_samples_mutex);
+	if (m_samples.size() < kMaxPendingSamples)
+	{
+		m_samples.emplace_back(sample);
+	}
+}
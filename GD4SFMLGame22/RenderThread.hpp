@@ -0,0 +1,61 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "RenderSnapshot.hpp"
+#include "TripleBuffer.hpp"
+#include "VertexStream.hpp"
+
+namespace sf
+{
+	class RenderWindow;
+}
+
+//Owns the window's OpenGL context while running and puts the most recently published RenderSnapshot on screen
+//The simulation thread records into BeginFrame and hands the frame over with Publish, neither side blocks the other
+//Events must still be polled on the thread that created the window
+class RenderThread : private sf::NonCopyable
+{
+public:
+	explicit RenderThread(sf::RenderWindow& window);
+	~RenderThread();
+
+	void Launch();
+	void Stop();
+	bool IsRunning() const;
+
+	RenderSnapshot& BeginFrame();
+	//Before Launch or after Stop the frame is presented straight away on the calling thread
+	void Publish();
+
+	//Waits until the render thread is done with the frame it is drawing and drops any published frame it has not started,
+	//frames only point at textures and geometry, so this has to happen before anything they may point at is destroyed
+	void Flush();
+
+	//Moves the samples of the frames presented since the last call onto the end of samples
+	//A frame that is never presented passes its times and count on to the next frame begun
+	void CollectSamples(std::vector<FrameSample>& samples);
+
+private:
+	//Only called on the simulation thread
+	void Drop(const FrameSample& sample);
+	void ExecutionThread();
+	void Present(const RenderSnapshot& snapshot);
+
+private:
+	sf::RenderWindow& m_window;
+	sf::Thread m_thread;
+	TripleBuffer<RenderSnapshot> m_snapshots;
+	//Times of the frames dropped since the last BeginFrame, only used by the simulation thread
+	FrameSample m_dropped;
+	std::atomic<bool> m_running;
+	//Held by the render thread while it picks up and draws a frame
+	std::mutex m_present_mutex;
+	VertexStream m_vertex_stream;
+	std::mutex m_samples_mutex;
+	std::vector<FrameSample> m_samples;
+};
@@ -16,6 +16,8 @@ public:
 	void Load(Identifier id, const std::string& filename, const Parameter& secondParam);
 	Resource& Get(Identifier id);
 	const Resource& Get(Identifier id) const;
+	//Registers a default constructed resource under id, for headless runs that look it up but never draw or play it
+	void LoadEmpty(Identifier id);
 
 private:
 	void InsertResource(Identifier id, std::unique_ptr<Resource> resource);
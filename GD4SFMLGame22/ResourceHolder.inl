@@ -25,6 +25,12 @@ void ResourceHolder<Resource, Identifier>::Load(Identifier id, const std::string
 	InsertResource(id, std::move(resource));
 }
 
+template<typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::LoadEmpty(Identifier id)
+{
+	InsertResource(id, std::unique_ptr<Resource>(new Resource()));
+}
+
 template<typename Resource, typename Identifier>
 Resource& ResourceHolder<Resource, Identifier>::Get(Identifier id)
 {
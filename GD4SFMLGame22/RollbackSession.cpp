@@ -0,0 +1,250 @@
+#include "RollbackSession.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "World.hpp"
+
+namespace
+{
+	const RollbackSession::Tick kInputDelay = 2;
+	//How far ticks are simulated ahead of the newest input every player has confirmed, about 200ms
+	const RollbackSession::Tick kMaxPrediction = 12;
+	//Room for the inputs of a peer running as far ahead as the session lets it
+	const std::size_t kInputHistory = 64;
+	const std::size_t kStateCount = kMaxPrediction + 1;
+	const RollbackSession::Tick kChecksumInterval = 30;
+	//Local checksums kept for peers that report theirs late
+	const std::size_t kChecksumHistory = 32;
+
+	static_assert(kInputHistory > 2 * (kMaxPrediction + kInputDelay), "The input history must cover a peer that is a full prediction window ahead");
+}
+
+RollbackSession::PlayerInputs::PlayerInputs(int identifier, bool local)
+	: m_identifier(identifier)
+	, m_local(local)
+	, m_confirmed_tick(0)
+	, m_inputs(kInputHistory, 0)
+	, m_simulated(kInputHistory, 0)
+{
+}
+
+RollbackSession::RollbackSession(World& world, sf::Time tick_time, InputHandler input_handler)
+	: m_world(world)
+	, m_tick_time(tick_time)
+	, m_input_handler(input_handler)
+	, m_players()
+	, m_states(kStateCount)
+	, m_current_tick(0)
+	, m_rollback_tick(0)
+	, m_resimulated_ticks(0)
+	, m_next_checksum_tick(0)
+	, m_local_checksums()
+	, m_pending_remote_checksums()
+	, m_outgoing_checksums()
+	, m_desynced(false)
+{
+	m_world.SetRollback(true);
+}
+
+//Nobody has input for the ticks inside the input delay yet, they are confirmed as empty for everyone
+void RollbackSession::AddPlayer(int identifier, bool local)
+{
+	assert(!FindPlayer(identifier));
+	m_players.emplace_back(identifier, local);
+	m_players.back().m_confirmed_tick = m_current_tick + kInputDelay - 1;
+}
+
+void RollbackSession::RemovePlayer(int identifier)
+{
+	m_players.erase(std::remove_if(m_players.begin(), m_players.end(), [identifier](const PlayerInputs& player)
+	{
+		return player.m_identifier == identifier;
+	}), m_players.end());
+}
+
+RollbackSession::Tick RollbackSession::AddLocalInput(int identifier, Input input)
+{
+	PlayerInputs* player = FindPlayer(identifier);
+	assert(player && player->m_local);
+	assert(player->m_confirmed_tick == m_current_tick + kInputDelay - 1);
+
+	Tick tick = ++player->m_confirmed_tick;
+	player->m_inputs[tick % kInputHistory] = input;
+	return tick;
+}
+
+//Inputs come over TCP, so each player's arrive in order and none are missing. A peer that skips a tick or
+//runs further ahead than the history holds cannot be simulated in step any more, which counts as a desync
+void RollbackSession::AddRemoteInput(int identifier, Tick tick, Input input)
+{
+	PlayerInputs* player = FindPlayer(identifier);
+	if (!player || tick <= player->m_confirmed_tick)
+	{
+		return;
+	}
+	if (tick != player->m_confirmed_tick + 1 || tick >= m_current_tick + static_cast<Tick>(kInputHistory) / 2)
+	{
+		m_desynced = true;
+		return;
+	}
+
+	player->m_inputs[tick % kInputHistory] = input;
+	player->m_confirmed_tick = tick;
+	if (tick < m_current_tick && player->m_simulated[tick % kInputHistory] != input)
+	{
+		m_rollback_tick = std::min(m_rollback_tick, tick);
+	}
+}
+
+bool RollbackSession::CanAdvance() const
+{
+	return m_current_tick - GetConfirmedTick() <= kMaxPrediction;
+}
+
+void RollbackSession::Advance()
+{
+	assert(CanAdvance());
+	Rollback();
+	UpdateChecksums();
+	Simulate(m_current_tick);
+	++m_current_tick;
+	m_rollback_tick = m_current_tick;
+}
+
+bool RollbackSession::PollChecksum(Tick& tick, std::uint32_t& checksum)
+{
+	if (m_outgoing_checksums.empty())
+	{
+		return false;
+	}
+	tick = m_outgoing_checksums.front().first;
+	checksum = m_outgoing_checksums.front().second;
+	m_outgoing_checksums.pop_front();
+	return true;
+}
+
+void RollbackSession::CheckRemoteChecksum(Tick tick, std::uint32_t checksum)
+{
+	auto local = m_local_checksums.find(tick);
+	if (local != m_local_checksums.end())
+	{
+		m_desynced = m_desynced || local->second != checksum;
+	}
+	else if (tick >= m_next_checksum_tick)
+	{
+		//This peer has not confirmed the tick yet
+		m_pending_remote_checksums.emplace(tick, checksum);
+	}
+}
+
+bool RollbackSession::HasDesynced() const
+{
+	return m_desynced;
+}
+
+RollbackSession::Tick RollbackSession::GetCurrentTick() const
+{
+	return m_current_tick;
+}
+
+std::size_t RollbackSession::GetResimulatedTicks() const
+{
+	return m_resimulated_ticks;
+}
+
+//32 bit FNV-1a over the state's bytes
+std::uint32_t RollbackSession::ComputeChecksum(const WorldState& state)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(state.GetData());
+	std::uint32_t hash = 2166136261u;
+	for (std::size_t i = 0; i < state.GetSize(); ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+//The newest tick for which every player's input is known
+RollbackSession::Tick RollbackSession::GetConfirmedTick() const
+{
+	Tick confirmed = std::numeric_limits<Tick>::max();
+	for (const PlayerInputs& player : m_players)
+	{
+		confirmed = std::min(confirmed, player.m_confirmed_tick);
+	}
+	return m_players.empty() ? m_current_tick : confirmed;
+}
+
+void RollbackSession::Rollback()
+{
+	if (m_rollback_tick >= m_current_tick)
+	{
+		return;
+	}
+	assert(m_current_tick - m_rollback_tick <= static_cast<Tick>(kStateCount));
+
+	//The ticks being replayed already played their sounds and sent their game actions
+	m_world.RestoreState(m_states[m_rollback_tick % kStateCount]);
+	m_world.SetReplaying(true);
+	for (Tick tick = m_rollback_tick; tick < m_current_tick; ++tick)
+	{
+		Simulate(tick);
+		++m_resimulated_ticks;
+	}
+	m_world.SetReplaying(false);
+	m_rollback_tick = m_current_tick;
+}
+
+//Players whose input for the tick has not arrived are predicted to keep doing what they did last
+void RollbackSession::Simulate(Tick tick)
+{
+	m_world.SaveState(m_states[tick % kStateCount]);
+
+	CommandQueue& commands = m_world.GetCommandQueue();
+	for (PlayerInputs& player : m_players)
+	{
+		Tick known_tick = std::min(tick, player.m_confirmed_tick);
+		Input input = player.m_inputs[known_tick % kInputHistory];
+		player.m_simulated[tick % kInputHistory] = input;
+		m_input_handler(player.m_identifier, input, commands);
+	}
+	m_world.Update(m_tick_time);
+}
+
+//A tick is checksummed once the inputs of every tick before it are confirmed, its saved state can no longer change
+void RollbackSession::UpdateChecksums()
+{
+	Tick confirmed = GetConfirmedTick();
+	while (m_next_checksum_tick < m_current_tick && m_next_checksum_tick <= confirmed + 1)
+	{
+		Tick tick = m_next_checksum_tick;
+		std::uint32_t checksum = ComputeChecksum(m_states[tick % kStateCount]);
+		m_local_checksums[tick] = checksum;
+		m_outgoing_checksums.emplace_back(tick, checksum);
+
+		auto pending = m_pending_remote_checksums.equal_range(tick);
+		for (auto itr = pending.first; itr != pending.second; ++itr)
+		{
+			m_desynced = m_desynced || itr->second != checksum;
+		}
+		m_pending_remote_checksums.erase(pending.first, pending.second);
+		m_next_checksum_tick += kChecksumInterval;
+	}
+
+	while (m_local_checksums.size() > kChecksumHistory)
+	{
+		m_local_checksums.erase(m_local_checksums.begin());
+	}
+}
+
+RollbackSession::PlayerInputs* RollbackSession::FindPlayer(int identifier)
+{
+	auto found = std::find_if(m_players.begin(), m_players.end(), [identifier](const PlayerInputs& player)
+	{
+		return player.m_identifier == identifier;
+	});
+	return found != m_players.end() ? &*found : nullptr;
+}
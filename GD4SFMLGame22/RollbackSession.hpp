@@ -0,0 +1,95 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "CommandQueue.hpp"
+#include "WorldState.hpp"
+
+class World;
+
+//Rollback networking for a World: peers only exchange the input of every tick
+//Ticks are simulated straight away with the remote inputs that have not arrived yet predicted to repeat the last known one
+//When a late input turns out to differ from its prediction, the World is restored to the tick it belongs to and re-simulated up to the present
+//Every peer checksums the same fully confirmed ticks, comparing them catches a simulation that drifted apart
+class RollbackSession : private sf::NonCopyable
+{
+public:
+	typedef std::int32_t Tick;
+	//One bit per PlayerAction
+	typedef std::uint8_t Input;
+	//Turns a player's input for a tick into commands for their aircraft
+	typedef std::function<void(int identifier, Input input, CommandQueue& commands)> InputHandler;
+
+public:
+	//Every peer has to step by the same tick_time, which is the fixed step of its Application
+	RollbackSession(World& world, sf::Time tick_time, InputHandler input_handler);
+
+	void AddPlayer(int identifier, bool local);
+	void RemovePlayer(int identifier);
+
+	//Local input is delayed by a couple of ticks, which hides most of the latency without a rollback
+	//Returns the tick it was scheduled for, to stamp it with when it is sent to the other peers
+	Tick AddLocalInput(int identifier, Input input);
+	//An input out of sequence or too far ahead is dropped and the session is flagged as desynced
+	void AddRemoteInput(int identifier, Tick tick, Input input);
+
+	//False while waiting for remote inputs, the session never predicts further ahead than it can roll back
+	bool CanAdvance() const;
+	void Advance();
+
+	bool PollChecksum(Tick& tick, std::uint32_t& checksum);
+	void CheckRemoteChecksum(Tick tick, std::uint32_t checksum);
+	bool HasDesynced() const;
+
+	Tick GetCurrentTick() const;
+	std::size_t GetResimulatedTicks() const;
+
+	static std::uint32_t ComputeChecksum(const WorldState& state);
+
+private:
+	struct PlayerInputs
+	{
+		PlayerInputs(int identifier, bool local);
+
+		int m_identifier;
+		bool m_local;
+		//Newest tick whose input is known for certain
+		Tick m_confirmed_tick;
+		//Known inputs, and the inputs each tick was last simulated with, indexed by tick modulo their size
+		std::vector<Input> m_inputs;
+		std::vector<Input> m_simulated;
+	};
+
+private:
+	Tick GetConfirmedTick() const;
+	void Rollback();
+	void Simulate(Tick tick);
+	void UpdateChecksums();
+	PlayerInputs* FindPlayer(int identifier);
+
+private:
+	World& m_world;
+	sf::Time m_tick_time;
+	InputHandler m_input_handler;
+	std::vector<PlayerInputs> m_players;
+	//The World as it was at the start of each of the last ticks, indexed by tick modulo their count
+	std::vector<WorldState> m_states;
+
+	Tick m_current_tick;
+	//Earliest tick simulated with a wrong prediction, m_current_tick when there is nothing to correct
+	Tick m_rollback_tick;
+	std::size_t m_resimulated_ticks;
+
+	Tick m_next_checksum_tick;
+	std::map<Tick, std::uint32_t> m_local_checksums;
+	std::multimap<Tick, std::uint32_t> m_pending_remote_checksums;
+	std::deque<std::pair<Tick, std::uint32_t>> m_outgoing_checksums;
+	bool m_desynced;
+};
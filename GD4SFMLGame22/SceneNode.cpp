@@ -4,11 +4,41 @@
 #include <cassert>
 #include <iostream>
 #include <SFML/Graphics/RectangleShape.hpp>
-#include <SFML/Graphics/RenderTarget.hpp>
 
+#include "RenderSnapshot.hpp"
 #include "Utility.hpp"
 
-SceneNode::SceneNode(Category::Type category):m_children(), m_parent(nullptr), m_default_category(category)
+SceneNode::Recycler::~Recycler()
+{
+}
+
+namespace
+{
+	bool IsEmpty(const sf::FloatRect& rect)
+	{
+		return rect.width <= 0.f || rect.height <= 0.f;
+	}
+
+	//Smallest rect holding both, an empty rect adds nothing
+	sf::FloatRect Union(const sf::FloatRect& first, const sf::FloatRect& second)
+	{
+		if (IsEmpty(first))
+		{
+			return second;
+		}
+		if (IsEmpty(second))
+		{
+			return first;
+		}
+		const float left = std::min(first.left, second.left);
+		const float top = std::min(first.top, second.top);
+		const float right = std::max(first.left + first.width, second.left + second.width);
+		const float bottom = std::max(first.top + first.height, second.top + second.height);
+		return sf::FloatRect(left, top, right - left, bottom - top);
+	}
+}
+
+SceneNode::SceneNode(Category::Type category):m_children(), m_parent(nullptr), m_default_category(category), m_recycler(nullptr)
 {
 }
 
@@ -30,6 +60,45 @@ SceneNode::Ptr SceneNode::DetachChild(const SceneNode& node)
 	return result;
 }
 
+void SceneNode::SetRecycler(Recycler* recycler)
+{
+	m_recycler = recycler;
+}
+
+void SceneNode::Dispose(Ptr node)
+{
+	//Pooled nodes go back to their pool, anything else is deleted when node goes out of scope
+	node->m_parent = nullptr;
+	node->OnDispose();
+	if (node->m_recycler)
+	{
+		Recycler* recycler = node->m_recycler;
+		recycler->Recycle(std::move(node));
+	}
+}
+
+void SceneNode::ResetTransform()
+{
+	setPosition(0.f, 0.f);
+	setRotation(0.f);
+	setScale(1.f, 1.f);
+	setOrigin(0.f, 0.f);
+}
+
+void SceneNode::DisposeChildren()
+{
+	for (Ptr& child : m_children)
+	{
+		Dispose(std::move(child));
+	}
+	m_children.clear();
+}
+
+void SceneNode::OnDispose()
+{
+	//Do nothing by default
+}
+
 void SceneNode::Update(sf::Time dt, CommandQueue& commands)
 {
 	UpdateCurrent(dt, commands);
@@ -64,28 +133,55 @@ void SceneNode::UpdateChildren(sf::Time dt, CommandQueue& commands)
 	}
 }
 
-void SceneNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
+void SceneNode::UpdateDrawBounds(const sf::Transform& parent_transform)
+{
+	const sf::Transform transform = parent_transform * getTransform();
+	const sf::FloatRect local_bounds = GetDrawBounds();
+	m_draw_bounds = IsEmpty(local_bounds) ? sf::FloatRect() : transform.transformRect(local_bounds);
+
+	m_subtree_bounds = m_draw_bounds;
+	for (const Ptr& child : m_children)
+	{
+		child->UpdateDrawBounds(transform);
+		m_subtree_bounds = Union(m_subtree_bounds, child->m_subtree_bounds);
+	}
+}
+
+void SceneNode::Draw(RenderSnapshot& snapshot, sf::RenderStates states, const sf::FloatRect& view_bounds) const
 {
+	//Nothing below this node is on screen
+	if (!m_subtree_bounds.intersects(view_bounds))
+	{
+		return;
+	}
+
 	//Apply transform of the current node
 	states.transform *= getTransform();
 
 	//Draw the node and children with changed transform
-	DrawCurrent(target, states);
-	DrawChildren(target, states);
-	sf::FloatRect rect = GetBoundingRect();
-	//DrawBoundingRect(target, states, rect);
+	if (m_draw_bounds.intersects(view_bounds))
+	{
+		DrawCurrent(snapshot, states);
+	}
+	DrawChildren(snapshot, states, view_bounds);
 }
 
-void SceneNode::DrawCurrent(sf::RenderTarget&, sf::RenderStates states) const
+void SceneNode::DrawCurrent(RenderSnapshot&, sf::RenderStates states) const
 {
 	//Do nothing by default
 }
 
-void SceneNode::DrawChildren(sf::RenderTarget& target, sf::RenderStates states) const
+sf::FloatRect SceneNode::GetDrawBounds() const
+{
+	//Draws nothing by default
+	return sf::FloatRect();
+}
+
+void SceneNode::DrawChildren(RenderSnapshot& snapshot, sf::RenderStates states, const sf::FloatRect& view_bounds) const
 {
 	for (const Ptr& child : m_children)
 	{
-		child->draw(target, states);
+		child->Draw(snapshot, states, view_bounds);
 	}
 }
 
@@ -119,7 +215,7 @@ sf::FloatRect SceneNode::GetBoundingRect() const
 	return sf::FloatRect();
 }
 
-void SceneNode::DrawBoundingRect(sf::RenderTarget& target, sf::RenderStates states, sf::FloatRect& rect) const
+void SceneNode::DrawBoundingRect(RenderSnapshot& snapshot, sf::RenderStates states, sf::FloatRect& rect) const
 {
 	sf::RectangleShape shape;
 	shape.setPosition(sf::Vector2f(rect.left, rect.top));
@@ -127,7 +223,7 @@ void SceneNode::DrawBoundingRect(sf::RenderTarget& target, sf::RenderStates stat
 	shape.setFillColor(sf::Color::Transparent);
 	shape.setOutlineColor(sf::Color::Green);
 	shape.setOutlineThickness(1.f);
-	target.draw(shape);
+	snapshot.Draw(shape);
 }
 
 bool Collision(const SceneNode& lhs, const SceneNode& rhs)
@@ -135,7 +231,7 @@ bool Collision(const SceneNode& lhs, const SceneNode& rhs)
 	return lhs.GetBoundingRect().intersects(rhs.GetBoundingRect());
 }
 
-void SceneNode::CheckNodeCollision(SceneNode& node, std::set<Pair>& collision_pairs)
+void SceneNode::CheckNodeCollision(SceneNode& node, PairSet& collision_pairs)
 {
 	if(this != &node && Collision(*this, node) && !IsDestroyed() && !node.IsDestroyed())
 	{
@@ -147,7 +243,7 @@ void SceneNode::CheckNodeCollision(SceneNode& node, std::set<Pair>& collision_pa
 	}
 }
 
-void SceneNode::CheckSceneCollision(SceneNode& scene_graph, std::set<Pair>& collision_pairs)
+void SceneNode::CheckSceneCollision(SceneNode& scene_graph, PairSet& collision_pairs)
 {
 	CheckNodeCollision(scene_graph, collision_pairs);
 	for(Ptr& child : scene_graph.m_children)
@@ -169,7 +265,34 @@ bool SceneNode::IsMarkedForRemoval() const
 
 void SceneNode::RemoveWrecks()
 {
-	auto wreck_field_begin = std::remove_if(m_children.begin(), m_children.end(), std::mem_fn(&SceneNode::IsMarkedForRemoval));
-	m_children.erase(wreck_field_begin, m_children.end());
+	RemoveMarkedChildren();
 	std::for_each(m_children.begin(), m_children.end(), std::mem_fn(&SceneNode::RemoveWrecks));
 }
+
+//Only this node's own children, World finds the parents to sweep through EntityStore::RemoveWrecks
+void SceneNode::RemoveMarkedChildren()
+{
+	//Compact in place rather than remove_if, the removed nodes have to survive the move so they can be disposed
+	auto survivor = m_children.begin();
+	for (auto itr = m_children.begin(); itr != m_children.end(); ++itr)
+	{
+		if ((*itr)->IsMarkedForRemoval())
+		{
+			Dispose(std::move(*itr));
+		}
+		else
+		{
+			if (survivor != itr)
+			{
+				*survivor = std::move(*itr);
+			}
+			++survivor;
+		}
+	}
+	m_children.erase(survivor, m_children.end());
+}
+
+SceneNode* SceneNode::GetParent() const
+{
+	return m_parent;
+}
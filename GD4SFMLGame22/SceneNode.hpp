@@ -2,7 +2,7 @@
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/Time.hpp>
 #include <SFML/Graphics/Transformable.hpp>
-#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
 
 #include <vector>
 #include <memory>
@@ -10,19 +10,38 @@
 
 #include "Command.hpp"
 #include "CommandQueue.hpp"
+#include "FrameArena.hpp"
 
-class SceneNode : public sf::Transformable, public sf::Drawable, private sf::NonCopyable
+class RenderSnapshot;
+
+class SceneNode : public sf::Transformable, private sf::NonCopyable
 {
 public:
 	typedef  std::unique_ptr<SceneNode> Ptr;
 	typedef std::pair<SceneNode*, SceneNode*> Pair;
+	typedef std::set<Pair, std::less<Pair>, FrameAllocator<Pair>> PairSet;
+	typedef std::vector<Pair, FrameAllocator<Pair>> PairList;
+
+	//Implemented by pools that want their nodes back instead of having them deleted
+	class Recycler
+	{
+	public:
+		virtual ~Recycler();
+		virtual void Recycle(Ptr node) = 0;
+	};
 
 public:
 	explicit SceneNode(Category::Type category = Category::kNone);
 	void AttachChild(Ptr child);
 	Ptr DetachChild(const SceneNode& node);
+	void SetRecycler(Recycler* recycler);
+	static void Dispose(Ptr node);
 
 	void Update(sf::Time dt, CommandQueue& commands);
+	//Refreshes the cached world bounds of this node and everything below it, call it before Draw once nodes have moved
+	void UpdateDrawBounds(const sf::Transform& parent_transform);
+	//Skips nodes, and whole subtrees, whose cached bounds are outside view_bounds
+	void Draw(RenderSnapshot& snapshot, sf::RenderStates states, const sf::FloatRect& view_bounds) const;
 
 	sf::Vector2f GetWorldPosition() const;
 	sf::Transform GetWorldTransform() const;
@@ -31,31 +50,41 @@ public:
 	virtual unsigned int GetCategory() const;
 	virtual sf::FloatRect GetBoundingRect() const;
 
-	void CheckSceneCollision(SceneNode& scene_graph, std::set<Pair>& collision_pairs);
+	void CheckSceneCollision(SceneNode& scene_graph, PairSet& collision_pairs);
 	void RemoveWrecks();
+	void RemoveMarkedChildren();
+	SceneNode* GetParent() const;
+
+	virtual bool IsDestroyed() const;
+	virtual bool IsMarkedForRemoval() const;
 
+protected:
+	void ResetTransform();
+	void DisposeChildren();
+	virtual void OnDispose();
 
 private:
 	virtual void UpdateCurrent(sf::Time dt, CommandQueue& commands);
 	void UpdateChildren(sf::Time dt, CommandQueue& commands);
 
-	//Note draw is from sf::Drawable hence the name, lower case d
-	virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
-	virtual void DrawCurrent(sf::RenderTarget&, sf::RenderStates states) const;
-	void DrawChildren(sf::RenderTarget& target, sf::RenderStates states) const;
-
-	void DrawBoundingRect(sf::RenderTarget& target, sf::RenderStates states, sf::FloatRect& bounding_rect) const;
+	virtual void DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const;
+	//What DrawCurrent draws in the node's own coordinates, nodes that override DrawCurrent must override this too
+	virtual sf::FloatRect GetDrawBounds() const;
+	void DrawChildren(RenderSnapshot& snapshot, sf::RenderStates states, const sf::FloatRect& view_bounds) const;
 
-	virtual bool IsDestroyed() const;
-	virtual bool IsMarkedForRemoval() const;
+	void DrawBoundingRect(RenderSnapshot& snapshot, sf::RenderStates states, sf::FloatRect& bounding_rect) const;
 	
-	void CheckNodeCollision(SceneNode& node, std::set<Pair>& collisionPairs);
+	void CheckNodeCollision(SceneNode& node, PairSet& collisionPairs);
 	
 
 private:
 	std::vector<Ptr> m_children;
 	SceneNode* m_parent;
 	Category::Type m_default_category;
+	Recycler* m_recycler;
+	//World bounds of what this node draws, and of what it and all its children draw
+	sf::FloatRect m_draw_bounds;
+	sf::FloatRect m_subtree_bounds;
 };
 bool Collision(const SceneNode& lhs, const SceneNode& rhs);
 float Distance(const SceneNode& lhs, const SceneNode& rhs);
@@ -3,7 +3,7 @@
 #include "ResourceHolder.hpp"
 #include "StateStack.hpp"
 
-#include <SFML/Graphics/RenderWindow.hpp>
+#include "RenderSnapshot.hpp"
 
 
 SettingsState::SettingsState(StateStack& stack, Context context)
@@ -33,12 +33,10 @@ SettingsState::SettingsState(StateStack& stack, Context context)
 	m_gui_container.Pack(back_button);
 }
 
-void SettingsState::Draw()
+void SettingsState::Draw(RenderSnapshot& snapshot)
 {
-	sf::RenderWindow& window = *GetContext().window;
-
-	window.draw(m_background_sprite);
-	window.draw(m_gui_container);
+	snapshot.Draw(m_background_sprite);
+	m_gui_container.Draw(snapshot, sf::RenderStates::Default);
 }
 
 bool SettingsState::Update(sf::Time)
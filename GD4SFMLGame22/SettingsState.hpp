@@ -18,7 +18,7 @@ class SettingsState : public State
 public:
 	SettingsState(StateStack& stack, Context context);
 
-	virtual void Draw();
+	virtual void Draw(RenderSnapshot& snapshot);
 	virtual bool Update(sf::Time dt);
 	virtual bool HandleEvent(const sf::Event& event);
 
@@ -0,0 +1,67 @@
+#include "SimMath.hpp"
+
+#include <cmath>
+
+#include "SimdKernels.hpp"
+
+const char* SimMath::GetModeName()
+{
+#ifdef SIMULATION_FIXED_POINT
+	return "Fixed";
+#else
+	return "float";
+#endif
+}
+
+SimScalar SimMath::ToSim(float value)
+{
+	return SimScalar(value);
+}
+
+SimVector SimMath::ToSim(sf::Vector2f vector)
+{
+	return SimVector(SimScalar(vector.x), SimScalar(vector.y));
+}
+
+float SimMath::ToFloat(float value)
+{
+	return value;
+}
+
+float SimMath::ToFloat(Fixed value)
+{
+	return value.ToFloat();
+}
+
+float SimMath::Sqrt(float value)
+{
+	return std::sqrt(value);
+}
+
+Fixed SimMath::Sqrt(Fixed value)
+{
+	return Fixed::Sqrt(value);
+}
+
+float SimMath::Atan2(float y, float x)
+{
+	return std::atan2(y, x);
+}
+
+Fixed SimMath::Atan2(Fixed y, Fixed x)
+{
+	return Fixed::Atan2(y, x);
+}
+
+void SimMath::Integrate(float* values, const float* rates, const float* weights, std::size_t count, float dt)
+{
+#ifdef SIMULATION_FIXED_POINT
+	const Fixed step(dt);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		values[i] = (Fixed(values[i]) + Fixed(rates[i]) * Fixed(weights[i]) * step).ToFloat();
+	}
+#else
+	SimdKernels::Integrate(values, rates, weights, count, dt);
+#endif
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+
+#include "Fixed.hpp"
+
+//Define SIMULATION_FIXED_POINT in the project's preprocessor definitions to run the gameplay maths in Fixed instead of float
+//Fixed is slower per operation, the benchmark shows by how much, but lockstep and rollback peers built by
+//different compilers or running on different CPUs then simulate exactly the same match
+#ifdef SIMULATION_FIXED_POINT
+typedef Fixed SimScalar;
+#else
+typedef float SimScalar;
+#endif
+typedef sf::Vector2<SimScalar> SimVector;
+
+//Gameplay maths in SimScalar. Entity state is still stored as float and converted on the way in and out,
+//both conversions are exact or correctly rounded so they add nothing for two machines to disagree on
+class SimMath
+{
+public:
+	static const char* GetModeName();
+
+	static SimScalar ToSim(float value);
+	static SimVector ToSim(sf::Vector2f vector);
+	static float ToFloat(float value);
+	static float ToFloat(Fixed value);
+	template <typename Scalar>
+	static sf::Vector2f ToFloat(sf::Vector2<Scalar> vector);
+
+	static float Sqrt(float value);
+	static Fixed Sqrt(Fixed value);
+	static float Atan2(float y, float x);
+	static Fixed Atan2(Fixed y, Fixed x);
+	template <typename Scalar>
+	static Scalar ToDegrees(Scalar radians);
+	template <typename Scalar>
+	static Scalar Length(sf::Vector2<Scalar> vector);
+	template <typename Scalar>
+	static sf::Vector2<Scalar> UnitVector(sf::Vector2<Scalar> vector);
+
+	//values[i] += rates[i] * weights[i] * dt over count floats, the SIMD kernel for float and a Fixed loop otherwise
+	static void Integrate(float* values, const float* rates, const float* weights, std::size_t count, float dt);
+};
+
+#include "SimMath.inl"
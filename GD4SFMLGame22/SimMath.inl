@@ -0,0 +1,26 @@
+#include <cassert>
+
+template <typename Scalar>
+sf::Vector2f SimMath::ToFloat(sf::Vector2<Scalar> vector)
+{
+	return sf::Vector2f(ToFloat(vector.x), ToFloat(vector.y));
+}
+
+template <typename Scalar>
+Scalar SimMath::ToDegrees(Scalar radians)
+{
+	return radians * Scalar(57.2957795f);
+}
+
+template <typename Scalar>
+Scalar SimMath::Length(sf::Vector2<Scalar> vector)
+{
+	return Sqrt(vector.x * vector.x + vector.y * vector.y);
+}
+
+template <typename Scalar>
+sf::Vector2<Scalar> SimMath::UnitVector(sf::Vector2<Scalar> vector)
+{
+	assert(vector != sf::Vector2<Scalar>());
+	return vector / Length(vector);
+}
@@ -0,0 +1,343 @@
+#include "SimdKernels.hpp"
+
+#include <cassert>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+//MSVC accepts every intrinsic without extra compiler switches
+#define SIMD_TARGET_SSE2
+#define SIMD_TARGET_AVX2
+#else
+#define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+	typedef void (*IntegrateKernel)(float*, const float*, const float*, std::size_t, float);
+	typedef std::size_t (*OverlapKernel)(const AabbArrays&, std::size_t, std::size_t, float, float, float, float, std::uint32_t*);
+	typedef std::size_t (*NearestKernel)(const float*, const float*, std::size_t, sf::Vector2f, float&);
+
+	struct KernelTable
+	{
+		SimdLevel m_level;
+		IntegrateKernel m_integrate;
+		OverlapKernel m_find_overlaps;
+		NearestKernel m_find_nearest;
+	};
+
+	void IntegrateScalar(float* values, const float* rates, const float* weights, std::size_t count, float dt)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			values[i] += rates[i] * weights[i] * dt;
+		}
+	}
+
+	std::size_t FindOverlapsScalar(const AabbArrays& boxes, std::size_t begin, std::size_t end,
+		float min_x, float min_y, float max_x, float max_y, std::uint32_t* out)
+	{
+		std::size_t found = 0;
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			if (boxes.m_min_x[i] < max_x && min_x < boxes.m_max_x[i] && boxes.m_min_y[i] < max_y && min_y < boxes.m_max_y[i])
+			{
+				out[found++] = static_cast<std::uint32_t>(i);
+			}
+		}
+		return found;
+	}
+
+	std::size_t FindNearestScalar(const float* xs, const float* ys, std::size_t count, sf::Vector2f position, float& distance_squared)
+	{
+		std::size_t nearest = count;
+		distance_squared = std::numeric_limits<float>::max();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			float dx = xs[i] - position.x;
+			float dy = ys[i] - position.y;
+			float candidate = dx * dx + dy * dy;
+			if (candidate < distance_squared)
+			{
+				distance_squared = candidate;
+				nearest = i;
+			}
+		}
+		return nearest;
+	}
+
+#ifdef SIMD_KERNELS_X86
+	//Picks the winner out of the per lane results, the lowest index wins a tie as in the scalar version
+	std::size_t ReduceNearest(const float* lane_distances, const std::int32_t* lane_indices, std::size_t lanes,
+		std::size_t nearest, float& distance_squared)
+	{
+		for (std::size_t lane = 0; lane < lanes; ++lane)
+		{
+			std::size_t index = static_cast<std::size_t>(lane_indices[lane]);
+			if (lane_indices[lane] >= 0 && (lane_distances[lane] < distance_squared
+				|| (lane_distances[lane] == distance_squared && index < nearest)))
+			{
+				distance_squared = lane_distances[lane];
+				nearest = index;
+			}
+		}
+		return nearest;
+	}
+
+	SIMD_TARGET_SSE2 void IntegrateSse2(float* values, const float* rates, const float* weights, std::size_t count, float dt)
+	{
+		const __m128 step = _mm_set1_ps(dt);
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 delta = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(rates + i), _mm_loadu_ps(weights + i)), step);
+			_mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), delta));
+		}
+		IntegrateScalar(values + i, rates + i, weights + i, count - i, dt);
+	}
+
+	SIMD_TARGET_SSE2 std::size_t FindOverlapsSse2(const AabbArrays& boxes, std::size_t begin, std::size_t end,
+		float min_x, float min_y, float max_x, float max_y, std::uint32_t* out)
+	{
+		const __m128 query_min_x = _mm_set1_ps(min_x);
+		const __m128 query_min_y = _mm_set1_ps(min_y);
+		const __m128 query_max_x = _mm_set1_ps(max_x);
+		const __m128 query_max_y = _mm_set1_ps(max_y);
+
+		std::size_t found = 0;
+		std::size_t i = begin;
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 overlap_x = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(boxes.m_min_x + i), query_max_x), _mm_cmplt_ps(query_min_x, _mm_loadu_ps(boxes.m_max_x + i)));
+			__m128 overlap_y = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(boxes.m_min_y + i), query_max_y), _mm_cmplt_ps(query_min_y, _mm_loadu_ps(boxes.m_max_y + i)));
+			int mask = _mm_movemask_ps(_mm_and_ps(overlap_x, overlap_y));
+			for (std::size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+			{
+				if (mask & 1)
+				{
+					out[found++] = static_cast<std::uint32_t>(i + lane);
+				}
+			}
+		}
+		return found + FindOverlapsScalar(boxes, i, end, min_x, min_y, max_x, max_y, out + found);
+	}
+
+	SIMD_TARGET_SSE2 std::size_t FindNearestSse2(const float* xs, const float* ys, std::size_t count, sf::Vector2f position, float& distance_squared)
+	{
+		const __m128 point_x = _mm_set1_ps(position.x);
+		const __m128 point_y = _mm_set1_ps(position.y);
+		__m128 best_distance = _mm_set1_ps(std::numeric_limits<float>::max());
+		__m128i best_index = _mm_set1_epi32(-1);
+		__m128i index = _mm_setr_epi32(0, 1, 2, 3);
+		const __m128i index_step = _mm_set1_epi32(4);
+
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), point_x);
+			__m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), point_y);
+			__m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+			__m128 closer = _mm_cmplt_ps(distance, best_distance);
+			__m128i closer_int = _mm_castps_si128(closer);
+			//SSE2 has no blend, select with and/andnot
+			best_distance = _mm_or_ps(_mm_and_ps(closer, distance), _mm_andnot_ps(closer, best_distance));
+			best_index = _mm_or_si128(_mm_and_si128(closer_int, index), _mm_andnot_si128(closer_int, best_index));
+			index = _mm_add_epi32(index, index_step);
+		}
+
+		float lane_distances[4];
+		std::int32_t lane_indices[4];
+		_mm_storeu_ps(lane_distances, best_distance);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lane_indices), best_index);
+
+		float tail_distance;
+		std::size_t nearest = FindNearestScalar(xs + i, ys + i, count - i, position, tail_distance);
+		nearest = (nearest == count - i) ? count : nearest + i;
+		distance_squared = tail_distance;
+		return ReduceNearest(lane_distances, lane_indices, 4, nearest, distance_squared);
+	}
+
+	SIMD_TARGET_AVX2 void IntegrateAvx2(float* values, const float* rates, const float* weights, std::size_t count, float dt)
+	{
+		const __m256 step = _mm256_set1_ps(dt);
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 delta = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(rates + i), _mm256_loadu_ps(weights + i)), step);
+			_mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), delta));
+		}
+		IntegrateScalar(values + i, rates + i, weights + i, count - i, dt);
+	}
+
+	SIMD_TARGET_AVX2 std::size_t FindOverlapsAvx2(const AabbArrays& boxes, std::size_t begin, std::size_t end,
+		float min_x, float min_y, float max_x, float max_y, std::uint32_t* out)
+	{
+		const __m256 query_min_x = _mm256_set1_ps(min_x);
+		const __m256 query_min_y = _mm256_set1_ps(min_y);
+		const __m256 query_max_x = _mm256_set1_ps(max_x);
+		const __m256 query_max_y = _mm256_set1_ps(max_y);
+
+		std::size_t found = 0;
+		std::size_t i = begin;
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256 overlap_x = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.m_min_x + i), query_max_x, _CMP_LT_OQ),
+				_mm256_cmp_ps(query_min_x, _mm256_loadu_ps(boxes.m_max_x + i), _CMP_LT_OQ));
+			__m256 overlap_y = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.m_min_y + i), query_max_y, _CMP_LT_OQ),
+				_mm256_cmp_ps(query_min_y, _mm256_loadu_ps(boxes.m_max_y + i), _CMP_LT_OQ));
+			int mask = _mm256_movemask_ps(_mm256_and_ps(overlap_x, overlap_y));
+			for (std::size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+			{
+				if (mask & 1)
+				{
+					out[found++] = static_cast<std::uint32_t>(i + lane);
+				}
+			}
+		}
+		return found + FindOverlapsScalar(boxes, i, end, min_x, min_y, max_x, max_y, out + found);
+	}
+
+	SIMD_TARGET_AVX2 std::size_t FindNearestAvx2(const float* xs, const float* ys, std::size_t count, sf::Vector2f position, float& distance_squared)
+	{
+		const __m256 point_x = _mm256_set1_ps(position.x);
+		const __m256 point_y = _mm256_set1_ps(position.y);
+		__m256 best_distance = _mm256_set1_ps(std::numeric_limits<float>::max());
+		__m256i best_index = _mm256_set1_epi32(-1);
+		__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		const __m256i index_step = _mm256_set1_epi32(8);
+
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), point_x);
+			__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), point_y);
+			__m256 distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+			__m256 closer = _mm256_cmp_ps(distance, best_distance, _CMP_LT_OQ);
+			best_distance = _mm256_blendv_ps(best_distance, distance, closer);
+			best_index = _mm256_blendv_epi8(best_index, index, _mm256_castps_si256(closer));
+			index = _mm256_add_epi32(index, index_step);
+		}
+
+		float lane_distances[8];
+		std::int32_t lane_indices[8];
+		_mm256_storeu_ps(lane_distances, best_distance);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lane_indices), best_index);
+
+		float tail_distance;
+		std::size_t nearest = FindNearestScalar(xs + i, ys + i, count - i, position, tail_distance);
+		nearest = (nearest == count - i) ? count : nearest + i;
+		distance_squared = tail_distance;
+		return ReduceNearest(lane_distances, lane_indices, 8, nearest, distance_squared);
+	}
+
+	SimdLevel DetectLevel()
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int max_leaf = info[0];
+		__cpuid(info, 1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		//AVX state has to be enabled by the OS as well as supported by the CPU
+		bool os_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+		bool avx2 = false;
+		if (os_avx && max_leaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		bool sse2 = __builtin_cpu_supports("sse2") != 0;
+		bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+		if (avx2)
+		{
+			return SimdLevel::kAvx2;
+		}
+		if (sse2)
+		{
+			return SimdLevel::kSse2;
+		}
+		return SimdLevel::kScalar;
+	}
+#else
+	SimdLevel DetectLevel()
+	{
+		return SimdLevel::kScalar;
+	}
+#endif
+
+	KernelTable MakeTable(SimdLevel level)
+	{
+		KernelTable table = { SimdLevel::kScalar, &IntegrateScalar, &FindOverlapsScalar, &FindNearestScalar };
+#ifdef SIMD_KERNELS_X86
+		if (level == SimdLevel::kSse2)
+		{
+			table = { SimdLevel::kSse2, &IntegrateSse2, &FindOverlapsSse2, &FindNearestSse2 };
+		}
+		else if (level == SimdLevel::kAvx2)
+		{
+			table = { SimdLevel::kAvx2, &IntegrateAvx2, &FindOverlapsAvx2, &FindNearestAvx2 };
+		}
+#endif
+		return table;
+	}
+
+	KernelTable& GetTable()
+	{
+		static KernelTable table = MakeTable(SimdKernels::GetSupportedLevel());
+		return table;
+	}
+}
+
+SimdLevel SimdKernels::GetSupportedLevel()
+{
+	static const SimdLevel level = DetectLevel();
+	return level;
+}
+
+SimdLevel SimdKernels::GetLevel()
+{
+	return GetTable().m_level;
+}
+
+void SimdKernels::SetLevel(SimdLevel level)
+{
+	assert(static_cast<int>(level) <= static_cast<int>(GetSupportedLevel()));
+	GetTable() = MakeTable(level);
+}
+
+const char* SimdKernels::GetLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::kSse2:
+		return "SSE2";
+	case SimdLevel::kAvx2:
+		return "AVX2";
+	default:
+		return "Scalar";
+	}
+}
+
+void SimdKernels::Integrate(float* values, const float* rates, const float* weights, std::size_t count, float dt)
+{
+	GetTable().m_integrate(values, rates, weights, count, dt);
+}
+
+std::size_t SimdKernels::FindOverlaps(const AabbArrays& boxes, std::size_t begin, std::size_t end,
+	float min_x, float min_y, float max_x, float max_y, std::uint32_t* out)
+{
+	return GetTable().m_find_overlaps(boxes, begin, end, min_x, min_y, max_x, max_y, out);
+}
+
+std::size_t SimdKernels::FindNearest(const float* xs, const float* ys, std::size_t count, sf::Vector2f position, float& distance_squared)
+{
+	return GetTable().m_find_nearest(xs, ys, count, position, distance_squared);
+}
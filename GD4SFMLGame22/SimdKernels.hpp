@@ -0,0 +1,44 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+enum class SimdLevel
+{
+	kScalar,
+	kSse2,
+	kAvx2
+};
+
+//Flat arrays of axis aligned boxes, as kept by EntityStore
+struct AabbArrays
+{
+	const float* m_min_x;
+	const float* m_min_y;
+	const float* m_max_x;
+	const float* m_max_y;
+};
+
+//Batched maths over structure of arrays data
+//Each kernel has a scalar, SSE2 and AVX2 version, the best one the CPU supports is picked the first time a kernel runs
+//All versions give the same results, SetLevel exists so the benchmark can compare them
+class SimdKernels
+{
+public:
+	static SimdLevel GetSupportedLevel();
+	static SimdLevel GetLevel();
+	static void SetLevel(SimdLevel level);
+	static const char* GetLevelName(SimdLevel level);
+
+	//values[i] += rates[i] * weights[i] * dt over count floats
+	static void Integrate(float* values, const float* rates, const float* weights, std::size_t count, float dt);
+
+	//Writes the indices in [begin, end) whose box overlaps the query box to out, returns how many were written
+	//Boxes that only touch do not overlap, matching sf::FloatRect::intersects
+	static std::size_t FindOverlaps(const AabbArrays& boxes, std::size_t begin, std::size_t end,
+		float min_x, float min_y, float max_x, float max_y, std::uint32_t* out);
+
+	//Index of the point closest to position, count if there are no points. Ties go to the lowest index
+	static std::size_t FindNearest(const float* xs, const float* ys, std::size_t count, sf::Vector2f position, float& distance_squared);
+};
@@ -1,6 +1,7 @@
 #include "SpriteNode.hpp"
 
-#include <SFML/Graphics/RenderTarget.hpp>
+#include "RenderSnapshot.hpp"
+
 
 SpriteNode::SpriteNode(const sf::Texture& texture):m_sprite(texture)
 {
@@ -10,7 +11,26 @@ SpriteNode::SpriteNode(const sf::Texture& texture, const sf::IntRect& textureRec
 {
 }
 
-void SpriteNode::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void SpriteNode::MakeStatic()
+{
+	m_static_geometry.reset(new StaticGeometry());
+	m_static_geometry->SetSprite(m_sprite);
+}
+
+void SpriteNode::DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const
+{
+	if (m_static_geometry)
+	{
+		states.texture = m_sprite.getTexture();
+		snapshot.Draw(*m_static_geometry, states);
+	}
+	else
+	{
+		snapshot.Draw(m_sprite, states);
+	}
+}
+
+sf::FloatRect SpriteNode::GetDrawBounds() const
 {
-	target.draw(m_sprite, states);
+	return m_sprite.getGlobalBounds();
 }
@@ -2,16 +2,24 @@
 #include "SceneNode.hpp"
 #include <SFML/Graphics/Sprite.hpp>
 
+#include <memory>
+
+#include "StaticGeometry.hpp"
+
 class SpriteNode : public SceneNode
 {
 public:
 	explicit SpriteNode(const sf::Texture& texture);
 	SpriteNode(const sf::Texture& texture, const sf::IntRect& textureRect);
+	//For sprites that never change, their quad is uploaded to the GPU once instead of being sent every frame
+	void MakeStatic();
 
 private:
-	virtual void DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual void DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const;
+	virtual sf::FloatRect GetDrawBounds() const;
 
 private:
 	sf::Sprite m_sprite;
+	std::unique_ptr<StaticGeometry> m_static_geometry;
 };
 
@@ -2,14 +2,18 @@
 
 #include "StateStack.hpp"
 
-State::Context::Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2)
+State::Context::Context(sf::RenderWindow& window, RenderThread& renderer, TextureHolder& textures, FontHolder& fonts, MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2, NetworkMode& network_mode, JobSystem& jobs, const sf::Time& time_per_update)
 : window(&window)
+, renderer(&renderer)
 , textures(&textures)
 , fonts(&fonts)
 , music(&music)
 , sounds(&sounds)
 , keys1(&keys1)
 , keys2(&keys2)
+, network_mode(&network_mode)
+, jobs(&jobs)
+, time_per_update(&time_per_update)
 {
 }
 
@@ -53,3 +57,8 @@ void State::OnDestroy()
 {
 
 }
+
+void State::SetInterpolation(float)
+{
+
+}
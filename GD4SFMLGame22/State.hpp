@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "MusicPlayer.hpp"
+#include "NetworkMode.hpp"
 #include "SoundPlayer.hpp"
 
 namespace sf
@@ -15,9 +16,12 @@ namespace sf
 	class RenderWindow;
 }
 
+class RenderSnapshot;
+class RenderThread;
 class StateStack;
 class Player;
 class KeyBinding;
+class JobSystem;
 
 class State
 {
@@ -26,24 +30,31 @@ public:
 
 	struct Context
 	{
-		Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2);
+		Context(sf::RenderWindow& window, RenderThread& renderer, TextureHolder& textures, FontHolder& fonts, MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2, NetworkMode& network_mode, JobSystem& jobs, const sf::Time& time_per_update);
 		sf::RenderWindow* window;
+		RenderThread* renderer;
 		TextureHolder* textures;
 		FontHolder* fonts;
 		MusicPlayer* music;
 		SoundPlayer* sounds;
 		KeyBinding* keys1;
 		KeyBinding* keys2;
+		NetworkMode* network_mode;
+		JobSystem* jobs;
+		//The fixed step every Update is called with
+		const sf::Time* time_per_update;
 	};
 
 public:
 	State(StateStack& stack, Context context);
 	virtual ~State();
-	virtual void Draw() = 0;
+	virtual void Draw(RenderSnapshot& snapshot) = 0;
 	virtual bool Update(sf::Time dt) = 0;
 	virtual bool HandleEvent(const sf::Event& event) = 0;
 	virtual void OnActivate();
 	virtual void OnDestroy();
+	//How far the renderer is between the last two updates, 0 to 1
+	virtual void SetInterpolation(float alpha);
 
 protected:
 	void RequestStackPush(StateID state_id);
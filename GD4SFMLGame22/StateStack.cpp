@@ -1,7 +1,10 @@
 #include "StateStack.hpp"
 
+#include <algorithm>
 #include <cassert>
 
+#include "RenderThread.hpp"
+
 StateStack::StateStack(State::Context context)
 :m_context(context)
 {
@@ -9,8 +12,10 @@ StateStack::StateStack(State::Context context)
 
 void StateStack::Update(sf::Time dt)
 {
+	m_updated_states.clear();
 	for (auto itr = m_stack.rbegin(); itr != m_stack.rend(); ++itr)
 	{
+		m_updated_states.emplace_back(itr->get());
 		if (!(*itr)->Update(dt))
 		{
 			break;
@@ -19,11 +24,21 @@ void StateStack::Update(sf::Time dt)
 	ApplyPendingChanges();
 }
 
-void StateStack::Draw()
+//States held back by one on top of them, e.g. the game behind the pause menu, are drawn as they are
+void StateStack::SetInterpolation(float alpha)
+{
+	for (State::Ptr& state : m_stack)
+	{
+		bool updated = std::find(m_updated_states.begin(), m_updated_states.end(), state.get()) != m_updated_states.end();
+		state->SetInterpolation(updated ? alpha : 1.f);
+	}
+}
+
+void StateStack::Draw(RenderSnapshot& snapshot)
 {
 	for(State::Ptr& state:m_stack)
 	{
-		state->Draw();
+		state->Draw(snapshot);
 	}
 }
 
@@ -76,6 +91,8 @@ void StateStack::ApplyPendingChanges()
 				m_stack.emplace_back(CreateState(change.state_id));
 				break;
 			case Action::Pop:
+				//The state may own what frames still on their way to the screen point at
+				m_context.renderer->Flush();
 				m_stack.back()->OnDestroy();
 				m_stack.pop_back();
 				if(!m_stack.empty())
@@ -84,6 +101,7 @@ void StateStack::ApplyPendingChanges()
 				}
 				break;
 			case Action::Clear:
+				m_context.renderer->Flush();
 				for(State::Ptr& state : m_stack)
 				{
 					state->OnDestroy();
@@ -34,7 +34,8 @@ public:
 	template <typename T, typename Param1>
 	void RegisterState(StateID state_id, Param1 arg1);
 	void Update(sf::Time dt);
-	void Draw();
+	void SetInterpolation(float alpha);
+	void Draw(RenderSnapshot& snapshot);
 	void HandleEvent(const sf::Event& event);
 
 	void PushState(StateID state_id);
@@ -58,6 +59,8 @@ private:
 private:
 	std::vector<State::Ptr> m_stack;
 	std::vector<PendingChange> m_pending_list;
+	//States that ran in the last Update, only they have moved and are worth interpolating
+	std::vector<const State*> m_updated_states;
 	State::Context m_context;
 	std::map<StateID, std::function<State::Ptr()>> m_state_factory;
 };
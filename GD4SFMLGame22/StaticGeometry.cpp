@@ -0,0 +1,60 @@
+#include "StaticGeometry.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+
+#include <cassert>
+
+#include "RenderSnapshot.hpp"
+
+StaticGeometry::StaticGeometry()
+	: m_primitive(sf::Triangles)
+	, m_buffer(sf::Triangles, sf::VertexBuffer::Static)
+	, m_uploaded(false)
+	, m_available(false)
+{
+}
+
+void StaticGeometry::SetVertices(const sf::Vertex* vertices, std::size_t vertex_count, sf::PrimitiveType type)
+{
+	assert(!m_uploaded);
+	m_vertices.assign(vertices, vertices + vertex_count);
+	m_primitive = type;
+}
+
+void StaticGeometry::SetSprite(const sf::Sprite& sprite)
+{
+	sf::Vertex quad[RenderSnapshot::kVerticesPerSprite];
+	RenderSnapshot::GetSpriteQuad(sprite, sf::Transform::Identity, quad);
+	SetVertices(quad, RenderSnapshot::kVerticesPerSprite, sf::Triangles);
+}
+
+std::size_t StaticGeometry::GetVertexCount() const
+{
+	return m_vertices.size();
+}
+
+void StaticGeometry::Draw(sf::RenderTarget& target, const sf::RenderStates& states) const
+{
+	if (m_vertices.empty())
+	{
+		return;
+	}
+
+	//Uploading needs the context, so it waits for the first draw on the render thread
+	if (!m_uploaded)
+	{
+		m_uploaded = true;
+		m_buffer.setPrimitiveType(m_primitive);
+		m_available = sf::VertexBuffer::isAvailable() && m_buffer.create(m_vertices.size()) && m_buffer.update(m_vertices.data());
+	}
+
+	if (m_available)
+	{
+		target.draw(m_buffer, states);
+	}
+	else
+	{
+		target.draw(m_vertices.data(), m_vertices.size(), m_primitive, states);
+	}
+}
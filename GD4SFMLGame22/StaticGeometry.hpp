@@ -0,0 +1,39 @@
+#pragma once
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace sf
+{
+	class RenderTarget;
+	class Sprite;
+}
+
+//Geometry that never changes, uploaded once to an sf::VertexBuffer with Static usage the first time it is drawn
+//Frames only record a reference to it, so neither the snapshot nor the GPU sees its vertices again
+//The vertices are set on the simulation thread before it is first drawn, Draw runs on the render thread
+//Draws from client memory where vertex buffers are not available
+class StaticGeometry : private sf::NonCopyable
+{
+public:
+	StaticGeometry();
+
+	void SetVertices(const sf::Vertex* vertices, std::size_t vertex_count, sf::PrimitiveType type);
+	//The sprite's quad in the coordinates of whatever it is drawn with
+	void SetSprite(const sf::Sprite& sprite);
+	std::size_t GetVertexCount() const;
+
+	void Draw(sf::RenderTarget& target, const sf::RenderStates& states) const;
+
+private:
+	std::vector<sf::Vertex> m_vertices;
+	sf::PrimitiveType m_primitive;
+	mutable sf::VertexBuffer m_buffer;
+	mutable bool m_uploaded;
+	mutable bool m_available;
+};
@@ -1,22 +1,35 @@
 #include "TextNode.hpp"
 
-#include <SFML/Graphics/RenderTarget.hpp>
 
+#include "RenderSnapshot.hpp"
 #include "ResourceHolder.hpp"
 #include "Utility.hpp"
 
 TextNode::TextNode(const FontHolder& fonts, const std::string& text)
 	: m_text(text, fonts.Get(Fonts::Main), 20)
+	, m_string(text)
 {
+	Utility::CentreOrigin(m_text);
 }
 
 void TextNode::SetString(const std::string& text)
 {
+	//Setting the string converts it and rebuilds the glyphs, and centring measures them again
+	if (text == m_string)
+	{
+		return;
+	}
+	m_string = text;
 	m_text.setString(text);
 	Utility::CentreOrigin(m_text);
 }
 
-void TextNode::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void TextNode::DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const
+{
+	snapshot.Draw(m_text, states);
+}
+
+sf::FloatRect TextNode::GetDrawBounds() const
 {
-	target.draw(m_text, states);
+	return m_text.getGlobalBounds();
 }
@@ -9,12 +9,15 @@ class TextNode : public SceneNode
 {
 public:
 	explicit TextNode(const FontHolder& fonts, const std::string& text);
+	//Does nothing when the string is unchanged, so it can be called every frame
 	void SetString(const std::string& text);
 
 private:
-	virtual void DrawCurrent(sf::RenderTarget&, sf::RenderStates states) const override;
+	virtual void DrawCurrent(RenderSnapshot& snapshot, sf::RenderStates states) const override;
+	virtual sf::FloatRect GetDrawBounds() const override;
 
 private:
 	sf::Text m_text;
+	std::string m_string;
 };
 
@@ -4,6 +4,7 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/System/Sleep.hpp>
 
+#include "RenderSnapshot.hpp"
 #include "ResourceHolder.hpp"
 
 TitleState::TitleState(StateStack& stack, Context context)
@@ -15,17 +16,16 @@ TitleState::TitleState(StateStack& stack, Context context)
 	m_text.setFont(context.fonts->Get(Fonts::Main));
 	m_text.setString("Press any key to continue");
 	Utility::CentreOrigin(m_text);
-	m_text.setPosition(context.window->getView().getSize() / 2.f);
+	m_text.setPosition(context.window->getDefaultView().getSize() / 2.f);
 }
 
-void TitleState::Draw()
+void TitleState::Draw(RenderSnapshot& snapshot)
 {
-	sf::RenderWindow& window = *GetContext().window;
-	window.draw(m_background_sprite);
+	snapshot.Draw(m_background_sprite);
 
 	if(m_show_text)
 	{
-		window.draw(m_text);
+		snapshot.Draw(m_text);
 	}
 }
 
@@ -8,7 +8,7 @@ class TitleState : public State
 {
 public:
 	TitleState(StateStack& stack, Context context);
-	virtual void Draw();
+	virtual void Draw(RenderSnapshot& snapshot);
 	virtual bool Update(sf::Time dt);
 	virtual bool HandleEvent(const sf::Event& event);
 
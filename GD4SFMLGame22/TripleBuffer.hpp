@@ -0,0 +1,36 @@
+#pragma once
+#include <SFML/System/NonCopyable.hpp>
+
+#include <atomic>
+
+//Hands whole values from one producer thread to one consumer thread without locking
+//The producer fills GetBack and calls Publish, the consumer calls Acquire and reads GetFront
+//Neither side ever waits on the other, a publish the consumer has not picked up yet is replaced by the next one,
+//which Publish reports
+template <typename Value>
+class TripleBuffer : private sf::NonCopyable
+{
+public:
+	TripleBuffer();
+
+	//Producer side
+	Value& GetBack();
+	//Returns true when it replaced a value the consumer never picked up, that value is the new back buffer
+	bool Publish();
+
+	//Consumer side, returns false and keeps the old front when nothing new has been published
+	bool Acquire();
+	const Value& GetFront() const;
+
+private:
+	static const unsigned int kIndexMask = 3;
+	static const unsigned int kFresh = 4;
+
+	Value m_buffers[3];
+	unsigned int m_back;
+	unsigned int m_front;
+	//Index of the buffer in the middle, plus kFresh when the producer has published since the last Acquire
+	std::atomic<unsigned int> m_shared;
+};
+
+#include "TripleBuffer.inl"
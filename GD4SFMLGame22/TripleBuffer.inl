@@ -0,0 +1,39 @@
+template <typename Value>
+TripleBuffer<Value>::TripleBuffer()
+	: m_back(0)
+	, m_front(1)
+	, m_shared(2)
+{
+}
+
+template <typename Value>
+Value& TripleBuffer<Value>::GetBack()
+{
+	return m_buffers[m_back];
+}
+
+template <typename Value>
+bool TripleBuffer<Value>::Publish()
+{
+	//Release makes the writes to the back buffer visible to the consumer that swaps it out
+	const unsigned int previous = m_shared.exchange(m_back | kFresh, std::memory_order_acq_rel);
+	m_back = previous & kIndexMask;
+	return (previous & kFresh) != 0;
+}
+
+template <typename Value>
+bool TripleBuffer<Value>::Acquire()
+{
+	if ((m_shared.load(std::memory_order_relaxed) & kFresh) == 0)
+	{
+		return false;
+	}
+	m_front = m_shared.exchange(m_front, std::memory_order_acq_rel) & kIndexMask;
+	return true;
+}
+
+template <typename Value>
+const Value& TripleBuffer<Value>::GetFront() const
+{
+	return m_buffers[m_front];
+}
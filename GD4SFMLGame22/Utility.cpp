@@ -7,19 +7,8 @@
 
 
 #include <cmath>
-#include <random>
 #include "Animation.hpp"
-
-namespace
-{
-	std::default_random_engine CreateRandomEngine()
-	{
-		auto seed = static_cast<unsigned long>(std::time(nullptr));
-		return std::default_random_engine(seed);
-	}
-
-	auto RandomEngine = CreateRandomEngine();
-}
+#include "Random.hpp"
 
 
 
@@ -168,7 +157,8 @@ sf::Vector2f Utility::UnitVector(sf::Vector2f vector)
 
 float Utility::Length(sf::Vector2f vector)
 {
-	return sqrtf(powf(vector.x, 2) + powf(vector.y, 2));
+	//Plain multiplies, powf goes through the general exponent path for what is just a square
+	return std::sqrt(vector.x * vector.x + vector.y * vector.y);
 }
 
 float Utility::ToDegrees(float angle_in_radians)
@@ -178,6 +168,6 @@ float Utility::ToDegrees(float angle_in_radians)
 
 int Utility::RandomInt(int exclusiveMax)
 {
-	std::uniform_int_distribution<> distr(0, exclusiveMax - 1);
-	return distr(RandomEngine);
+	//Each thread draws from its own stream, nothing is shared between the server thread, the workers and the game
+	return Random::ForThisThread().NextInt(exclusiveMax);
 }
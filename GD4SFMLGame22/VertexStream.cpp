@@ -0,0 +1,49 @@
+#include "VertexStream.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+VertexStream::VertexStream(std::size_t capacity)
+	: m_buffer(sf::Triangles, sf::VertexBuffer::Stream)
+	, m_capacity(capacity)
+	, m_offset(0)
+	, m_created(false)
+	, m_available(false)
+{
+}
+
+void VertexStream::Draw(sf::RenderTarget& target, const sf::Vertex* vertices, std::size_t vertex_count, sf::PrimitiveType type, const sf::RenderStates& states)
+{
+	if (!m_created)
+	{
+		Create();
+	}
+	if (!m_available || vertex_count > m_capacity)
+	{
+		target.draw(vertices, vertex_count, type, states);
+		return;
+	}
+
+	if (m_offset + vertex_count > m_capacity)
+	{
+		//Recreating the storage orphans the old one, the driver keeps it alive until the GPU is done with it
+		m_buffer.create(m_capacity);
+		m_offset = 0;
+	}
+
+	m_buffer.update(vertices, vertex_count, static_cast<unsigned int>(m_offset));
+	m_buffer.setPrimitiveType(type);
+	target.draw(m_buffer, m_offset, vertex_count, states);
+	m_offset += vertex_count;
+}
+
+bool VertexStream::IsStreaming() const
+{
+	return m_available;
+}
+
+void VertexStream::Create()
+{
+	m_created = true;
+	m_available = sf::VertexBuffer::isAvailable() && m_buffer.create(m_capacity);
+}
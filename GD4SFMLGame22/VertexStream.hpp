@@ -0,0 +1,38 @@
+#pragma once
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <cstddef>
+
+namespace sf
+{
+	class RenderTarget;
+	class Vertex;
+}
+
+//Vertices that change every frame, streamed through one sf::VertexBuffer with Stream usage
+//Each draw is written into the next free range of the buffer. When a range no longer fits, the storage is orphaned
+//and writing starts again at the front, so an upload never waits for the GPU to finish with the previous frames
+//Draws straight from client memory, as before, when vertex buffers are not available or a draw is bigger than the buffer
+//Only used on the thread that owns the OpenGL context
+class VertexStream : private sf::NonCopyable
+{
+public:
+	explicit VertexStream(std::size_t capacity);
+
+	void Draw(sf::RenderTarget& target, const sf::Vertex* vertices, std::size_t vertex_count, sf::PrimitiveType type, const sf::RenderStates& states);
+	bool IsStreaming() const;
+
+private:
+	//Needs a context, so it happens on the first draw rather than in the constructor
+	void Create();
+
+private:
+	sf::VertexBuffer m_buffer;
+	std::size_t m_capacity;
+	std::size_t m_offset;
+	bool m_created;
+	bool m_available;
+};
@@ -1,40 +1,82 @@
 #include "World.hpp"
 
-sf::Clock timer;
+#include <cassert>
+#include <cstdint>
 
+#include "RenderSnapshot.hpp"
+#include "SimMath.hpp"
 
-World::World(sf::RenderTarget& output_target, FontHolder& font, SoundPlayer& sounds, bool networked)
+namespace
+{
+	//Tags the entity records of a WorldState
+	enum class StateRecord : std::uint8_t
+	{
+		kEnd,
+		kAircraft,
+		kProjectile,
+		kPickup
+	};
+}
+
+
+World::World(sf::RenderTarget& output_target, FontHolder& font, SoundPlayer& sounds, JobSystem& jobs, bool networked)
+	: World(&output_target, output_target.getDefaultView(), &font, &sounds, jobs, networked)
+{
+}
+
+World::World(sf::Vector2f view_size, JobSystem& jobs, bool networked)
+	: World(nullptr, sf::View(sf::FloatRect(0.f, 0.f, view_size.x, view_size.y)), nullptr, nullptr, jobs, networked)
+{
+}
+
+World::World(sf::RenderTarget* output_target, const sf::View& camera, FontHolder* font, SoundPlayer* sounds, JobSystem& jobs, bool networked)
 	: m_target(output_target)
-	, m_camera(output_target.getDefaultView())
+	, m_camera(camera)
 	, m_textures()
 	, m_fonts(font)
 	, m_sounds(sounds)
+	, m_entity_store()
+	, m_entity_factory(m_textures, m_entity_store)
 	, m_scenegraph()
 	, m_scene_layers()
+	, m_job_system(jobs)
 	, m_world_bounds(0.f, 0.f, 1920, 1088)
 	, m_position1(m_world_bounds.width / 2, m_world_bounds.height / 6)
 	, m_spawn_position(m_camera.getSize().x/2.f, m_world_bounds.height - m_camera.getSize().y /2.f)
 	, m_scrollspeed(-50.f)
 	, m_scrollspeed_compensation(1.f)
 	, m_player_aircraft()
+	, m_aircraft_registry()
 	, m_enemy_spawn_points()
 	, m_ball_spawn_points()
-	, m_active_enemies()
+	, m_active_enemies(FrameAllocator<EntityHandle>(m_frame_arena))
+	, m_active_enemy_x(FrameAllocator<float>(m_frame_arena))
+	, m_active_enemy_y(FrameAllocator<float>(m_frame_arena))
 	, m_PickupQueue()
+	, m_respawn_time(sf::Time::Zero)
 	, m_networked_world(networked)
 	, m_network_node(nullptr)
 	, m_finish_sprite(nullptr)
 	,m_game_started(false)
+	, m_replaying(false)
+	, m_rollback(false)
+	, m_interpolation(1.f)
+	, m_background_cache()
+	, m_cache_background(true)
 {
-	m_scene_texture.create(m_target.getSize().x, m_target.getSize().y);
+	if (m_target)
+	{
+		m_scene_texture.create(m_target->getSize().x, m_target->getSize().y);
+	}
 
 	LoadTextures();
 	BuildScene();
+	BuildUpdateJobs();
 	m_camera.setCenter(m_spawn_position);
 
 	for (int i = 0; i < 6; i++) 
 	{
-		m_PickupQueue.push(i);
+		m_PickupQueue.push_back(i);
 	}
 
 }
@@ -49,41 +91,54 @@ void World::Update(sf::Time dt)
 	//Scroll the world
 	//m_camera.move(0, m_scrollspeed * dt.asSeconds()*m_scrollspeed_compensation);
 	
-	for (Aircraft* a : m_player_aircraft)
+	for (EntityHandle handle : m_player_aircraft)
 	{
-		a->SetVelocity(0.f, 0.f);
+		ResolveAircraft(handle)->SetVelocity(0.f, 0.f);
 	}
 
-	DestroyEntitiesOutsideView();
+	m_entity_store.CullOutside(GetBattlefieldBounds());
 	GuideMissiles();
 
 	//Forward commands to the scenegraph until the command queue is empty
 	while(!m_command_queue.IsEmpty())
 	{
-		m_scenegraph.OnCommand(m_command_queue.Pop(), dt);
+		DispatchCommand(m_command_queue.Pop(), dt);
 	}
 	AdaptPlayerVelocity();
 
 	HandleCollisions();
-	//Remove all destroyed entities
-	//RemoveWrecks() only destroys the entities, not the pointers in m_player_aircraft
-	auto first_to_remove = std::remove_if(m_player_aircraft.begin(), m_player_aircraft.end(), std::mem_fn(&Aircraft::IsMarkedForRemoval));
+	//Remove all destroyed entities, then forget the players whose handles no longer resolve
+	m_entity_store.RemoveWrecks();
+	auto first_to_remove = std::remove_if(m_player_aircraft.begin(), m_player_aircraft.end(), [this](EntityHandle handle)
+	{
+		return !m_entity_store.GetEntity(handle);
+	});
 	m_player_aircraft.erase(first_to_remove, m_player_aircraft.end());
-	m_scenegraph.RemoveWrecks();
 
 	SpawnEnemies();
 
 	//Apply movement
 	m_scenegraph.Update(dt, m_command_queue);
-	AdaptPlayerPosition();
+	m_update_time = dt;
+	m_job_system.Run(m_update_jobs);
 
-	UpdateSounds();
+	//Otherwise what the entities asked for this tick, e.g. throwing, is carried out at the start of the next one
+	while(m_rollback && !m_command_queue.IsEmpty())
+	{
+		DispatchCommand(m_command_queue.Pop(), dt);
+	}
 
 	CheckRespawn();
 
+	ReleaseFrameMemory();
 }
 
-void World::Draw()
+void World::SetInterpolation(float alpha)
+{
+	m_interpolation = alpha;
+}
+
+void World::Draw(RenderSnapshot& snapshot)
 {
 	//if(PostEffect::IsSupported())
 	//{
@@ -95,21 +150,51 @@ void World::Draw()
 	//}
 	//else
 
-	m_target.setView(m_camera);
-	m_target.draw(m_scenegraph);
+	//Draw the entities between their last two simulated positions, then put them back for the next Update
+	m_entity_store.Interpolate(m_interpolation);
+	m_scenegraph.UpdateDrawBounds(sf::Transform::Identity);
+	const sf::FloatRect view_bounds = GetViewBounds();
+	snapshot.SetView(m_camera);
+	//Layers are drawn one after the other, within a layer every sprite of a texture goes in one draw call
+	for (SceneNode* layer : m_scene_layers)
+	{
+		if (layer == m_scene_layers[static_cast<int>(Layers::kBackground)] && m_cache_background)
+		{
+			if (!m_background_cache.IsValid(m_camera))
+			{
+				m_background_cache.Record(m_camera, [layer, &view_bounds](RenderSnapshot& contents)
+				{
+					contents.BeginSpriteBatch();
+					layer->Draw(contents, sf::RenderStates::Default, view_bounds);
+					contents.EndSpriteBatch();
+				});
+			}
+			snapshot.Draw(m_background_cache);
+			continue;
+		}
+
+		snapshot.BeginSpriteBatch();
+		layer->Draw(snapshot, sf::RenderStates::Default, view_bounds);
+		snapshot.EndSpriteBatch();
+	}
+	m_entity_store.Interpolate(1.f);
 	
 }
 
 Aircraft* World::GetAircraft(int identifier) const
 {
-	for(Aircraft * a : m_player_aircraft)
-	{
-		if (a->GetIdentifier() == identifier)
-		{
-			return a;
-		}
-	}
-	return nullptr;
+	//The handle goes stale once the aircraft leaves the world, which resolves to nullptr
+	return static_cast<Aircraft*>(m_entity_store.GetEntity(m_aircraft_registry.Get(identifier)));
+}
+
+void World::SetLocalAircraft(int identifier)
+{
+	m_aircraft_registry.SetLocal(identifier, true);
+}
+
+bool World::IsLocalAircraft(int identifier) const
+{
+	return m_aircraft_registry.IsLocal(identifier);
 }
 
 void World::RemoveAircraft(int identifier)
@@ -118,7 +203,8 @@ void World::RemoveAircraft(int identifier)
 	if (aircraft)
 	{
 		aircraft->Destroy();
-		m_player_aircraft.erase(std::find(m_player_aircraft.begin(), m_player_aircraft.end(), aircraft));
+		m_player_aircraft.erase(std::find(m_player_aircraft.begin(), m_player_aircraft.end(), aircraft->GetHandle()));
+		m_aircraft_registry.Remove(identifier);
 	}
 }
 
@@ -126,40 +212,40 @@ Aircraft* World::AddAircraft(int identifier, bool team)
 {
 	if (team) 
 	{
-		std::unique_ptr<Aircraft> player(new Aircraft(AircraftType::kTeamPink, m_textures, m_fonts));
+		std::unique_ptr<Aircraft> player = m_entity_factory.CreateAircraft(AircraftType::kTeamPink, m_fonts);
 		player->setPosition(m_camera.getCenter());
 		player->SetIdentifier(identifier);
 		player->setScale(sf::Vector2f(3, 3));
 		player->SetTeamPink(team);
-		m_player_aircraft.emplace_back(player.get());
+		Aircraft* aircraft = player.get();
+		m_player_aircraft.emplace_back(aircraft->GetHandle());
+		m_aircraft_registry.Add(identifier, aircraft->GetHandle());
 		m_scene_layers[static_cast<int>(Layers::kUpperAir)]->AttachChild(std::move(player));
-		return m_player_aircraft.back();
+		return aircraft;
 	}
 	else 
 	{
-		std::unique_ptr<Aircraft> player(new Aircraft(AircraftType::kTeamBlue, m_textures, m_fonts));
+		std::unique_ptr<Aircraft> player = m_entity_factory.CreateAircraft(AircraftType::kTeamBlue, m_fonts);
 		player->setPosition(m_camera.getCenter());
 		player->SetIdentifier(identifier);
 		player->setScale(sf::Vector2f(-3, 3));
 		player->SetTeamPink(team);
-		m_player_aircraft.emplace_back(player.get());
+		Aircraft* aircraft = player.get();
+		m_player_aircraft.emplace_back(aircraft->GetHandle());
+		m_aircraft_registry.Add(identifier, aircraft->GetHandle());
 		m_scene_layers[static_cast<int>(Layers::kUpperAir)]->AttachChild(std::move(player));
-		return m_player_aircraft.back();
+		return aircraft;
 	}
 }
 
 void World::CreatePickup(sf::Vector2f position, PickupType type)
 {
-	std::unique_ptr<Pickup> pickup(new Pickup(type, m_textures));
-	pickup->setPosition(position);
-	pickup->SetVelocity(0.f, 0.f);
-	pickup->setScale(2.f, 2.f);
-	m_scene_layers[static_cast<int>(Layers::kUpperAir)]->AttachChild(std::move(pickup));
+	CreatePickup(position, type, 0);
 }
 
 void World::CreatePickup(sf::Vector2f position, PickupType type, int index)
 {
-	std::unique_ptr<Pickup> pickup(new Pickup(type, m_textures, index));
+	std::unique_ptr<Pickup> pickup = m_entity_factory.CreatePickup(type, index);
 	pickup->setPosition(position);
 	pickup->SetVelocity(0.f, 0.f);
 	pickup->setScale(2.f, 2.f);
@@ -174,7 +260,7 @@ bool World::PollGameAction(GameActions::Action& out)
 void World::StartGame()
 {
 	m_game_started = true;
-	//timer.restart();
+	m_respawn_time = sf::Time::Zero;
 }
 
 bool World::HasGameStarted()
@@ -182,6 +268,133 @@ bool World::HasGameStarted()
 	return m_game_started;
 }
 
+bool World::IsHeadless() const
+{
+	return m_target == nullptr;
+}
+
+//Entities are written in store order, RestoreState puts them back in the same slots
+//Wrecks waiting for removal and aircraft that left the match no longer take part and are skipped
+void World::SaveState(WorldState& state) const
+{
+	state.Clear();
+	state.Write(m_camera.getCenter());
+	state.Write(m_game_started);
+	state.Write(m_respawn_time.asMicroseconds());
+	state.Write(m_entity_factory.GetRandom().GetState());
+	state.Write(static_cast<std::uint32_t>(m_PickupQueue.size()));
+	for (int index : m_PickupQueue)
+	{
+		state.Write(static_cast<std::int32_t>(index));
+	}
+
+	for (EntityStore::Index i = 0; i < m_entity_store.GetSize(); ++i)
+	{
+		Entity* entity = m_entity_store.GetOwner(i);
+		if (Aircraft* aircraft = dynamic_cast<Aircraft*>(entity))
+		{
+			if (std::find(m_player_aircraft.begin(), m_player_aircraft.end(), aircraft->GetHandle()) == m_player_aircraft.end())
+			{
+				continue;
+			}
+			state.Write(StateRecord::kAircraft);
+			state.Write(static_cast<std::int32_t>(aircraft->GetIdentifier()));
+			state.Write(aircraft->GetTeamPink());
+			aircraft->SaveState(state);
+		}
+		else if (entity->IsDestroyed())
+		{
+			continue;
+		}
+		else if (Projectile* projectile = dynamic_cast<Projectile*>(entity))
+		{
+			state.Write(StateRecord::kProjectile);
+			state.Write(static_cast<std::uint8_t>(projectile->GetType()));
+			projectile->SaveState(state);
+		}
+		else if (Pickup* pickup = dynamic_cast<Pickup*>(entity))
+		{
+			state.Write(StateRecord::kPickup);
+			state.Write(static_cast<std::uint8_t>(pickup->GetType()));
+			state.Write(static_cast<std::int32_t>(pickup->GetIndex()));
+			pickup->SaveState(state);
+		}
+	}
+	state.Write(StateRecord::kEnd);
+}
+
+//Players keep their aircraft, which are rewound in place. Projectiles and pickups are short lived,
+//they go back to their pools and are recreated from the state
+void World::RestoreState(const WorldState& state)
+{
+	WorldState::Reader reader(state);
+	m_camera.setCenter(reader.Read<sf::Vector2f>());
+	m_game_started = reader.Read<bool>();
+	m_respawn_time = sf::microseconds(reader.Read<sf::Int64>());
+	m_entity_factory.GetRandom().SetState(reader.Read<Random::State>());
+	m_PickupQueue.resize(reader.Read<std::uint32_t>());
+	for (int& index : m_PickupQueue)
+	{
+		index = reader.Read<std::int32_t>();
+	}
+
+	RemoveShortLivedEntities();
+	m_restore_players.swap(m_player_aircraft);
+	m_player_aircraft.clear();
+
+	EntityStore::Index slot = 0;
+	for (StateRecord record = reader.Read<StateRecord>(); record != StateRecord::kEnd; record = reader.Read<StateRecord>())
+	{
+		Entity* entity = nullptr;
+		if (record == StateRecord::kAircraft)
+		{
+			int identifier = reader.Read<std::int32_t>();
+			bool team = reader.Read<bool>();
+			Aircraft* aircraft = GetAircraft(identifier);
+			if (aircraft)
+			{
+				m_player_aircraft.emplace_back(aircraft->GetHandle());
+			}
+			else
+			{
+				aircraft = AddAircraft(identifier, team);
+			}
+			aircraft->RestoreState(reader);
+			entity = aircraft;
+		}
+		else if (record == StateRecord::kProjectile)
+		{
+			std::unique_ptr<Projectile> projectile = m_entity_factory.CreateProjectile(static_cast<ProjectileType>(reader.Read<std::uint8_t>()));
+			projectile->RestoreState(reader);
+			entity = projectile.get();
+			m_scene_layers[static_cast<int>(Layers::kLowerAir)]->AttachChild(std::move(projectile));
+		}
+		else
+		{
+			assert(record == StateRecord::kPickup);
+			PickupType type = static_cast<PickupType>(reader.Read<std::uint8_t>());
+			std::unique_ptr<Pickup> pickup = m_entity_factory.CreatePickup(type, reader.Read<std::int32_t>());
+			pickup->RestoreState(reader);
+			entity = pickup.get();
+			m_scene_layers[static_cast<int>(Layers::kUpperAir)]->AttachChild(std::move(pickup));
+		}
+		m_entity_store.PlaceAt(slot++, *entity);
+	}
+	assert(reader.IsAtEnd());
+
+	//Players that joined after the state was saved leave again
+	for (EntityHandle handle : m_restore_players)
+	{
+		Aircraft* aircraft = static_cast<Aircraft*>(m_entity_store.GetEntity(handle));
+		if (aircraft && std::find(m_player_aircraft.begin(), m_player_aircraft.end(), handle) == m_player_aircraft.end())
+		{
+			aircraft->Destroy();
+			m_aircraft_registry.Remove(aircraft->GetIdentifier());
+		}
+	}
+	m_restore_players.clear();
+}
+
 void World::SetCurrentBattleFieldPosition(float lineY)
 {
 	m_camera.setCenter(m_camera.getCenter().x, lineY - m_camera.getSize().y / 2);
@@ -209,11 +422,27 @@ bool World::HasPlayerReachedEnd() const
 
 void World::LoadTextures()
 {
-	m_textures.Load(Textures::kEntities, "Media/Textures/Dodgeball_Spritesheet.png");
-	m_textures.Load(Textures::KCourt, "Media/Textures/court.png");
-	m_textures.Load(Textures::kSplatter, "Media/Textures/Splatter.png");
-	m_textures.Load(Textures::kParticle, "Media/Textures/Particle.png");
-	m_textures.Load(Textures::kFinishLine, "Media/Textures/FinishLine.png");
+	const std::pair<Textures, const char*> textures[] =
+	{
+		{ Textures::kEntities, "Media/Textures/Dodgeball_Spritesheet.png" },
+		{ Textures::KCourt, "Media/Textures/court.png" },
+		{ Textures::kSplatter, "Media/Textures/Splatter.png" },
+		{ Textures::kParticle, "Media/Textures/Particle.png" },
+		{ Textures::kFinishLine, "Media/Textures/FinishLine.png" }
+	};
+
+	//Sprite sizes come from the data tables rather than the textures, so a headless world simulates the same with empty ones
+	for (const auto& texture : textures)
+	{
+		if (IsHeadless())
+		{
+			m_textures.LoadEmpty(texture.first);
+		}
+		else
+		{
+			m_textures.Load(texture.first, texture.second);
+		}
+	}
 }
 
 void World::BuildScene()
@@ -239,6 +468,7 @@ void World::BuildScene()
 
 	std::unique_ptr<SpriteNode> court_sprite(new SpriteNode(court_texture, texture_rect));
 	court_sprite->setPosition(m_world_bounds.left, m_world_bounds.top);
+	court_sprite->MakeStatic();
 	//floor_sprite->setPosition(-500, 0);
 	m_scene_layers[static_cast<int>(Layers::kBackground)]->AttachChild(std::move(court_sprite));
 
@@ -246,20 +476,24 @@ void World::BuildScene()
 	sf::Texture& finish_texture = m_textures.Get(Textures::kFinishLine);
 	std::unique_ptr<SpriteNode> finish_sprite(new SpriteNode(finish_texture));
 	finish_sprite->setPosition(0.f, -76.f);
+	finish_sprite->MakeStatic();
 	m_finish_sprite = finish_sprite.get();
 	m_scene_layers[static_cast<int>(Layers::kBackground)]->AttachChild(std::move(finish_sprite));
 
 	// Add particle node to the scene
-	std::unique_ptr<ParticleNode> smokeNode(new ParticleNode(ParticleType::kSmoke, m_textures));
+	std::unique_ptr<ParticleNode> smokeNode(new ParticleNode(ParticleType::kSmoke, m_textures, m_job_system));
 	m_scene_layers[static_cast<int>(Layers::kLowerAir)]->AttachChild(std::move(smokeNode));
 
 	// Add propellant particle node to the scene
-	std::unique_ptr<ParticleNode> propellantNode(new ParticleNode(ParticleType::kPropellant, m_textures));
+	std::unique_ptr<ParticleNode> propellantNode(new ParticleNode(ParticleType::kPropellant, m_textures, m_job_system));
 	m_scene_layers[static_cast<int>(Layers::kLowerAir)]->AttachChild(std::move(propellantNode));
 
-	// Add sound effect node
-	std::unique_ptr<SoundNode> soundNode(new SoundNode(m_sounds));
-	m_scenegraph.AttachChild(std::move(soundNode));
+	// Add sound effect node, sound commands find no receiver in a headless world
+	if (m_sounds)
+	{
+		std::unique_ptr<SoundNode> soundNode(new SoundNode(*m_sounds));
+		m_scenegraph.AttachChild(std::move(soundNode));
+	}
 
 	if(m_networked_world)
 	{
@@ -275,6 +509,41 @@ void World::BuildScene()
 	
 }
 
+//Players are kept on screen after they moved and the listener follows them, cleaning up finished sounds
+//touches neither the entities nor the listener so it runs alongside. A headless world has neither sound job
+//Animations only change texture rects, so they play alongside the movement
+void World::BuildUpdateJobs()
+{
+	JobGraph::NodeId integrate = m_update_jobs.Add([this]
+	{
+		m_entity_store.Integrate(m_update_time.asSeconds(), m_job_system);
+	});
+	JobGraph::NodeId adapt_position = m_update_jobs.Add([this]
+	{
+		AdaptPlayerPosition();
+	});
+	m_update_jobs.Precede(integrate, adapt_position);
+	m_update_jobs.Add([this]
+	{
+		m_entity_factory.GetAnimator().Update(m_update_time);
+	});
+	if (!m_sounds)
+	{
+		return;
+	}
+
+	JobGraph::NodeId listener = m_update_jobs.Add([this]
+	{
+		UpdateListener();
+	});
+	m_update_jobs.Add([this]
+	{
+		// Remove unused sounds
+		m_sounds->RemoveStoppedSounds();
+	});
+	m_update_jobs.Precede(adapt_position, listener);
+}
+
 CommandQueue& World::GetCommandQueue()
 {
 	return m_command_queue;
@@ -285,29 +554,36 @@ void World::AdaptPlayerPosition()
 	
 	//Keep all players on the screen, at least border_distance from the border
 	sf::FloatRect view_bounds = GetViewBounds();
-	const float border_distance = 40.f;
-	for (Aircraft* aircraft : m_player_aircraft)
+	const SimScalar border_distance(40.f);
+	const SimScalar left = SimMath::ToSim(view_bounds.left) + border_distance;
+	const SimScalar right = SimMath::ToSim(view_bounds.left) + SimMath::ToSim(view_bounds.width) - border_distance;
+	const SimScalar top = SimMath::ToSim(view_bounds.top) + border_distance;
+	const SimScalar bottom = SimMath::ToSim(view_bounds.top) + SimMath::ToSim(view_bounds.height) - border_distance;
+	const SimScalar middle = SimMath::ToSim(m_world_bounds.width) / SimScalar(2.f);
+	for (EntityHandle handle : m_player_aircraft)
 	{
-		
-		sf::Vector2f position = aircraft->getPosition();
-		position.x = std::max(position.x, view_bounds.left + border_distance);
-		position.x = std::min(position.x, view_bounds.left + view_bounds.width - border_distance);
-		position.y = std::max(position.y, view_bounds.top + border_distance);
-		position.y = std::min(position.y, view_bounds.top + view_bounds.height - border_distance);
+		Aircraft* aircraft = ResolveAircraft(handle);
+		SimVector position = SimMath::ToSim(aircraft->getPosition());
+		position.x = std::max(position.x, left);
+		position.x = std::min(position.x, right);
+		position.y = std::max(position.y, top);
+		position.y = std::min(position.y, bottom);
 
 		if (aircraft->GetTeamPink() == true) {
-			if (position.x >= (m_world_bounds.width / 2)) {
-				position.x = m_world_bounds.width / 2;
+			if (position.x >= middle) {
+				position.x = middle;
 			}
 		}
 
 		if (aircraft->GetTeamPink() == false) {
-			if (position.x <= (m_world_bounds.width / 2)) {
-				position.x = m_world_bounds.width / 2;
+			if (position.x <= middle) {
+				position.x = middle;
 			}
 		}
-		aircraft->setPosition(position);
-
+		if (SimMath::ToFloat(position) != aircraft->getPosition())
+		{
+			aircraft->TravelTo(SimMath::ToFloat(position));
+		}
 		
 
 	}
@@ -315,19 +591,31 @@ void World::AdaptPlayerPosition()
 
 void World::AdaptPlayerVelocity()
 {
-	for (Aircraft* aircraft : m_player_aircraft)
+	for (EntityHandle handle : m_player_aircraft)
 	{
+		Aircraft* aircraft = ResolveAircraft(handle);
 		sf::Vector2f velocity = aircraft->GetVelocity();
 		//if moving diagonally then reduce velocity
 		if (velocity.x != 0.f && velocity.y != 0.f)
 		{
-			aircraft->SetVelocity(velocity / std::sqrt(2.f));
+			aircraft->SetVelocity(SimMath::ToFloat(SimMath::ToSim(velocity) / SimMath::Sqrt(SimScalar(2.f))));
 		}
 		//Add scrolling velocity
 		//aircraft->Accelerate(0.f, m_scrollspeed);
 	}
 }
 
+void World::SetBackgroundCached(bool cached)
+{
+	m_cache_background = cached;
+	m_background_cache.Invalidate();
+}
+
+void World::InvalidateBackground()
+{
+	m_background_cache.Invalidate();
+}
+
 sf::FloatRect World::GetViewBounds() const
 {
 	return sf::FloatRect(m_camera.getCenter() - m_camera.getSize() / 2.f, m_camera.getSize());
@@ -350,7 +638,7 @@ void World::SpawnEnemies()
 	{
 		SpawnPoint spawn = m_enemy_spawn_points.back();
 		//std::cout << static_cast<int>(spawn.m_type) << std::endl;
-		std::unique_ptr<Aircraft> enemy(new Aircraft(spawn.m_type, m_textures, m_fonts));
+		std::unique_ptr<Aircraft> enemy = m_entity_factory.CreateAircraft(spawn.m_type, m_fonts);
 		enemy->setPosition(spawn.m_x, spawn.m_y);
 		enemy->setRotation(180.f);
 		//If the game is networked the server is responsible for spawning pickups
@@ -482,7 +770,12 @@ void World::GuideMissiles()
 	enemyCollector.action = DerivedAction<Aircraft>([this](Aircraft& enemy, sf::Time)
 	{
 		if (!enemy.IsDestroyed())
-			m_active_enemies.emplace_back(&enemy);
+		{
+			sf::Vector2f position = enemy.GetWorldPosition();
+			m_active_enemies.emplace_back(enemy.GetHandle());
+			m_active_enemy_x.emplace_back(position.x);
+			m_active_enemy_y.emplace_back(position.y);
+		}
 	});
 
 	// Setup command that guides all missiles to the enemy which is currently closest to the player
@@ -494,29 +787,21 @@ void World::GuideMissiles()
 		if (!missile.IsGuided())
 			return;
 
-		float minDistance = std::numeric_limits<float>::max();
-		Aircraft* closestEnemy = nullptr;
-
 		// Find closest enemy
-		for(Aircraft * enemy :  m_active_enemies)
-		{
-			float enemyDistance = Distance(missile, *enemy);
-
-			if (enemyDistance < minDistance)
-			{
-				closestEnemy = enemy;
-				minDistance = enemyDistance;
-			}
-		}
+		float distance_squared;
+		std::size_t closest = SimdKernels::FindNearest(m_active_enemy_x.data(), m_active_enemy_y.data(), m_active_enemies.size(),
+			missile.GetWorldPosition(), distance_squared);
 
-		if (closestEnemy)
-			missile.GuideTowards(closestEnemy->GetWorldPosition());
+		if (closest < m_active_enemies.size())
+			missile.GuideTowards(sf::Vector2f(m_active_enemy_x[closest], m_active_enemy_y[closest]));
 	});
 
 	// Push commands, reset active enemies
 	m_command_queue.Push(enemyCollector);
 	m_command_queue.Push(missileGuider);
 	m_active_enemies.clear();
+	m_active_enemy_x.clear();
+	m_active_enemy_y.clear();
 }
 
 bool MatchesCategories(SceneNode::Pair& colliders, Category::Type type1, Category::Type type2)
@@ -540,8 +825,12 @@ bool MatchesCategories(SceneNode::Pair& colliders, Category::Type type1, Categor
 
 void World::HandleCollisions()
 {
-	std::set<SceneNode::Pair> collision_pairs;
-	m_scenegraph.CheckSceneCollision(m_scenegraph, collision_pairs);
+	//Projectiles fired while handling this frame's commands have not been measured yet
+	m_entity_store.RefreshBounds();
+
+	FrameAllocator<SceneNode::Pair> allocator(m_frame_arena);
+	SceneNode::PairList collision_pairs(allocator);
+	m_entity_store.FindCollisionPairs(collision_pairs, m_job_system);
 	for(SceneNode::Pair pair : collision_pairs)
 	{
 		if(MatchesCategories(pair, Category::Type::kPlayerAircraft, Category::Type::kEnemyAircraft))
@@ -572,7 +861,7 @@ void World::HandleCollisions()
 			{
 				//sf::Vector2f resetPos = pickup.getPosition();
 				
-				m_PickupQueue.push(pickup->GetIndex());
+				m_PickupQueue.push_back(pickup->GetIndex());
 
 				pickup->Apply(player);
 				pickup->Destroy();
@@ -599,22 +888,7 @@ void World::HandleCollisions()
 	}
 }
 
-void World::DestroyEntitiesOutsideView()
-{
-	Command command;
-	command.category = Category::Type::kEnemyAircraft | Category::Type::kProjectile;
-	command.action = DerivedAction<Entity>([this](Entity& e, sf::Time)
-	{
-		//Does the object intersect with the battlefield
-		if (!GetBattlefieldBounds().intersects(e.GetBoundingRect()))
-		{
-			e.Remove();
-		}
-	});
-	m_command_queue.Push(command);
-}
-
-void World::UpdateSounds()
+void World::UpdateListener()
 {
 	sf::Vector2f listener_position;
 
@@ -627,31 +901,97 @@ void World::UpdateSounds()
 	// 1 or more players -> mean position between all aircrafts
 	else
 	{
-		for (Aircraft* aircraft : m_player_aircraft)
+		for (EntityHandle handle : m_player_aircraft)
 		{
-			listener_position += aircraft->GetWorldPosition();
+			listener_position += ResolveAircraft(handle)->GetWorldPosition();
 		}
 
 		listener_position /= static_cast<float>(m_player_aircraft.size());
 	}
 
 	// Set listener's position
-	m_sounds.SetListenerPosition(listener_position);
-
-	// Remove unused sounds
-	m_sounds.RemoveStoppedSounds();
+	m_sounds->SetListenerPosition(listener_position);
 }
 
 void World::CheckRespawn()
 {
 
-	if (m_game_started && timer.getElapsedTime().asSeconds() >= 3) {
-		timer.restart();
+	m_respawn_time += m_update_time;
+	if (m_game_started && m_respawn_time.asSeconds() >= 3) {
+		m_respawn_time = sf::Time::Zero;
 		//RespawnBalls()
 		while (!m_PickupQueue.empty()) {
 			int index = m_PickupQueue.front();
-			m_PickupQueue.pop();
+			m_PickupQueue.pop_front();
 			RespawnBalls(index);
 		}
 	}
 }
+
+void World::SetReplaying(bool replaying)
+{
+	m_replaying = replaying;
+}
+
+void World::SetRollback(bool rollback)
+{
+	m_rollback = rollback;
+}
+
+//Hands every live projectile and pickup back to its pool
+void World::RemoveShortLivedEntities()
+{
+	m_restore_removals.clear();
+	for (EntityStore::Index i = 0; i < m_entity_store.GetSize(); ++i)
+	{
+		Entity* entity = m_entity_store.GetOwner(i);
+		if (dynamic_cast<Projectile*>(entity) || dynamic_cast<Pickup*>(entity))
+		{
+			m_restore_removals.emplace_back(entity);
+		}
+	}
+	for (Entity* entity : m_restore_removals)
+	{
+		SceneNode::Dispose(entity->GetParent()->DetachChild(*entity));
+	}
+	m_restore_removals.clear();
+}
+
+void World::ReleaseFrameMemory()
+{
+	//Containers backed by the frame arena must give up their storage before the arena is rewound
+	ActiveEnemyList(FrameAllocator<EntityHandle>(m_frame_arena)).swap(m_active_enemies);
+	FrameFloatList(FrameAllocator<float>(m_frame_arena)).swap(m_active_enemy_x);
+	FrameFloatList(FrameAllocator<float>(m_frame_arena)).swap(m_active_enemy_y);
+	m_frame_arena.Reset();
+}
+
+void World::DispatchCommand(const Command& command, sf::Time dt)
+{
+	if (m_replaying && (command.category & (Category::kSoundEffect | Category::kNetwork)))
+	{
+		return;
+	}
+
+	//Addressed commands run on exactly one aircraft instead of visiting the whole scene graph
+	if (command.target_identifier != Command::kNoTarget)
+	{
+		Aircraft* aircraft = GetAircraft(command.target_identifier);
+		if (aircraft && (command.category & aircraft->GetCategory()))
+		{
+			command.action(*aircraft, dt);
+		}
+	}
+	else
+	{
+		m_scenegraph.OnCommand(command, dt);
+	}
+}
+
+//Handles in m_player_aircraft are pruned right after wrecks are removed, so a stale one here is a bug
+Aircraft* World::ResolveAircraft(EntityHandle handle) const
+{
+	Entity* entity = m_entity_store.GetEntity(handle);
+	assert(entity);
+	return static_cast<Aircraft*>(entity);
+}
@@ -16,11 +16,19 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 
 #include <array>
+#include <deque>
 #include <iostream>
 #include <limits>
 
-#include "BloomEffect.hpp"
+#include "AircraftRegistry.hpp"
+#include "CachedLayer.hpp"
 #include "CommandQueue.hpp"
+#include "EntityFactory.hpp"
+#include "EntityHandle.hpp"
+#include "EntityStore.hpp"
+#include "FrameArena.hpp"
+#include "JobSystem.hpp"
+#include "SimdKernels.hpp"
 #include "SoundPlayer.hpp"
 
 #include "NetworkProtocol.hpp"
@@ -33,20 +41,28 @@
 #include "Projectile.hpp"
 #include "SoundNode.hpp"
 #include "Utility.hpp"
+#include "WorldState.hpp"
 
 namespace sf
 {
 	class RenderTarget;
 }
 
+class RenderSnapshot;
+
 
 
 class World : private sf::NonCopyable
 {
 public:
-	explicit World(sf::RenderTarget& output_target, FontHolder& font, SoundPlayer& sounds, bool networked=false);
+	//jobs is shared with whatever else runs in the process, a World does not start threads of its own
+	World(sf::RenderTarget& output_target, FontHolder& font, SoundPlayer& sounds, JobSystem& jobs, bool networked=false);
+	//Headless: the full simulation with nothing to draw to or play through, no textures are loaded,
+	//aircraft carry no text and no sounds are played. view_size stands in for the target's default view
+	World(sf::Vector2f view_size, JobSystem& jobs, bool networked=false);
 	void Update(sf::Time dt);
-	void Draw();
+	void SetInterpolation(float alpha);
+	void Draw(RenderSnapshot& snapshot);
 
 	sf::FloatRect GetViewBounds() const;
 	CommandQueue& GetCommandQueue();
@@ -64,6 +80,8 @@ public:
 
 	void SetWorldScrollCompensation(float compensation);
 	Aircraft* GetAircraft(int identifier) const;
+	void SetLocalAircraft(int identifier);
+	bool IsLocalAircraft(int identifier) const;
 	sf::FloatRect GetBattlefieldBounds() const;
 	void CreatePickup(sf::Vector2f position, PickupType type);
 
@@ -72,10 +90,26 @@ public:
 
 	void StartGame();
 	bool HasGameStarted();
+	bool IsHeadless() const;
+
+	//Everything that decides how the match plays out from here: players, projectiles in flight, pickups and
+	//the respawn queue, timers and the random stream. Cheap enough to save every tick
+	void SaveState(WorldState& state) const;
+	void RestoreState(const WorldState& state);
+	//While replaying ticks that already ran once, their sounds and network game actions are dropped
+	void SetReplaying(bool replaying);
+	//Rollback ticks also carry out the commands the entities queued during the tick, so nothing is left
+	//queued between ticks and a saved state holds everything that decides the next one
+	void SetRollback(bool rollback);
+	//The background layer never changes, cached it is drawn as one image of itself until the camera moves
+	void SetBackgroundCached(bool cached);
+	void InvalidateBackground();
 
 private:
+	World(sf::RenderTarget* output_target, const sf::View& camera, FontHolder* font, SoundPlayer* sounds, JobSystem& jobs, bool networked);
 	void LoadTextures();
 	void BuildScene();
+	void BuildUpdateJobs();
 	void AdaptPlayerPosition();
 	void AdaptPlayerVelocity();
 
@@ -86,9 +120,12 @@ private:
 	void RespawnBalls(int index);
 	void GuideMissiles();
 	void HandleCollisions();
-	void DestroyEntitiesOutsideView();
-	void UpdateSounds();
+	void UpdateListener();
 	void CheckRespawn();
+	void ReleaseFrameMemory();
+	void RemoveShortLivedEntities();
+	void DispatchCommand(const Command& command, sf::Time dt);
+	Aircraft* ResolveAircraft(EntityHandle handle) const;
 
 private:
 	struct SpawnPoint
@@ -102,30 +139,43 @@ private:
 		float m_y;
 	};
 
+	typedef std::vector<EntityHandle, FrameAllocator<EntityHandle>> ActiveEnemyList;
+	typedef std::vector<float, FrameAllocator<float>> FrameFloatList;
+
 
 
 private:
-	sf::RenderTarget& m_target;
+	//Null in a headless world, along with m_fonts and m_sounds
+	sf::RenderTarget* m_target;
 	sf::RenderTexture m_scene_texture;
 	sf::View m_camera;
 	TextureHolder m_textures;
-	FontHolder& m_fonts;
-	SoundPlayer& m_sounds;
+	FontHolder* m_fonts;
+	SoundPlayer* m_sounds;
+	EntityStore m_entity_store;
+	EntityFactory m_entity_factory;
 	SceneNode m_scenegraph;
 	std::array<SceneNode*, static_cast<int>(Layers::kLayerCount)> m_scene_layers;
 	CommandQueue m_command_queue;
+	FrameArena m_frame_arena;
+	JobSystem& m_job_system;
+	//The end of Update, from integrating movement to the sound listener, run on m_job_system
+	JobGraph m_update_jobs;
+	sf::Time m_update_time;
 
 	sf::FloatRect m_world_bounds;
 	sf::Vector2f m_spawn_position;
 	float m_scrollspeed;
 	float m_scrollspeed_compensation;
-	std::vector<Aircraft*> m_player_aircraft;
+	std::vector<EntityHandle> m_player_aircraft;
+	AircraftRegistry m_aircraft_registry;
 	std::vector<SpawnPoint> m_enemy_spawn_points;
-	std::vector<Aircraft*>	m_active_enemies;
+	ActiveEnemyList m_active_enemies;
+	FrameFloatList m_active_enemy_x;
+	FrameFloatList m_active_enemy_y;
 
 	std::vector<SpawnPoint> m_ball_spawn_points;
 
-	BloomEffect m_bloom_effect;
 	bool m_networked_world;
 	NetworkNode* m_network_node;
 	SpriteNode* m_finish_sprite;
@@ -136,9 +186,19 @@ private:
 	sf::Vector2f m_position4;
 	sf::Vector2f m_position5;
 
-	std::queue<int> m_PickupQueue;
+	std::deque<int> m_PickupQueue;
+	//Simulated time since the balls in m_PickupQueue were last put back
+	sf::Time m_respawn_time;
+	//Scratch lists for RestoreState, kept so restoring every tick does not allocate
+	std::vector<Entity*> m_restore_removals;
+	std::vector<EntityHandle> m_restore_players;
 
 	bool m_game_started;
+	bool m_replaying;
+	bool m_rollback;
+	float m_interpolation;
+	CachedLayer m_background_cache;
+	bool m_cache_background;
 
 	//sf::Clock startTimer;
 };
@@ -0,0 +1,39 @@
+#include "WorldState.hpp"
+
+WorldState::Reader::Reader(const WorldState& state)
+	: m_state(state)
+	, m_position(0)
+{
+}
+
+bool WorldState::Reader::IsAtEnd() const
+{
+	return m_position == m_state.m_bytes.size();
+}
+
+WorldState::WorldState()
+	: m_bytes()
+{
+}
+
+void WorldState::Clear()
+{
+	m_bytes.clear();
+}
+
+//For a state that arrived from elsewhere, e.g. over the network
+void WorldState::Assign(const void* data, std::size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	m_bytes.assign(bytes, bytes + size);
+}
+
+const void* WorldState::GetData() const
+{
+	return m_bytes.data();
+}
+
+std::size_t WorldState::GetSize() const
+{
+	return m_bytes.size();
+}
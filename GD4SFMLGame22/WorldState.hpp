@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+//Compact binary image of the simulation state of a World, written by World::SaveState and read back by World::RestoreState
+//Values are stored as their raw bytes with no tags or byte swapping, so a state only makes sense to the build that wrote it
+//Clear keeps the storage, a WorldState reused every tick stops allocating once it has grown to the size of a match
+class WorldState
+{
+public:
+	//Reads a state front to back, any number of Readers can read the same state
+	class Reader
+	{
+	public:
+		explicit Reader(const WorldState& state);
+
+		template <typename Value>
+		Value Read();
+		bool IsAtEnd() const;
+
+	private:
+		const WorldState& m_state;
+		std::size_t m_position;
+	};
+
+public:
+	WorldState();
+
+	void Clear();
+	void Assign(const void* data, std::size_t size);
+	template <typename Value>
+	void Write(const Value& value);
+
+	const void* GetData() const;
+	std::size_t GetSize() const;
+
+private:
+	std::vector<char> m_bytes;
+};
+
+#include "WorldState.inl"
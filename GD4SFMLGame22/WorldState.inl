@@ -0,0 +1,22 @@
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+template <typename Value>
+void WorldState::Write(const Value& value)
+{
+	static_assert(std::is_trivially_copyable<Value>::value, "WorldState only stores plain values");
+	const char* bytes = reinterpret_cast<const char*>(&value);
+	m_bytes.insert(m_bytes.end(), bytes, bytes + sizeof(Value));
+}
+
+template <typename Value>
+Value WorldState::Reader::Read()
+{
+	static_assert(std::is_trivially_copyable<Value>::value, "WorldState only stores plain values");
+	assert(m_position + sizeof(Value) <= m_state.m_bytes.size());
+	Value value;
+	std::memcpy(&value, m_state.m_bytes.data() + m_position, sizeof(Value));
+	m_position += sizeof(Value);
+	return value;
+}